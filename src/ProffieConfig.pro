@@ -36,9 +36,15 @@ SOURCES += \
     main.cpp \
     core/appstate.cpp \
     core/utilities/fileparse.cpp \
+    core/utilities/json.cpp \
     core/utilities/misc.cpp \
+    core/utilities/notifier.cpp \
     core/utilities/progress.cpp \
+    core/config/buildsizes.cpp \
     core/config/configuration.cpp \
+    core/config/sourcemap.cpp \
+    core/config/costmodel.cpp \
+    core/config/definetable.cpp \
     core/config/settings.cpp \
     core/config/propfile.cpp \
     editor/pages/generalpage.cpp \
@@ -51,7 +57,26 @@ SOURCES += \
     onboard/pages/overviewpage.cpp \
     onboard/pages/welcomepage.cpp \
     tools/arduino.cpp \
+    tools/batchverify.cpp \
+    tools/boardwatch.cpp \
+    tools/builddirs.cpp \
+    tools/capturesearch.cpp \
+    tools/compileprogress.cpp \
+    tools/compilercache.cpp \
+    tools/dfureboot.cpp \
+    tools/faketoolchain.cpp \
+    tools/firmwarecache.cpp \
+    tools/flashstation.cpp \
+    tools/presetsync.cpp \
+    tools/process.cpp \
+    tools/serialcapture.cpp \
     tools/serialmonitor.cpp \
+    tools/serialwriter.cpp \
+    tools/sizedashboard.cpp \
+    tools/sketchoverlay.cpp \
+    tools/speculativebuild.cpp \
+    tools/toolchain.cpp \
+    ui/logview.cpp \
     ui/pccombobox.cpp \
     ui/pcspinctrl.cpp \
     ui/pcspinctrldouble.cpp \
@@ -60,11 +85,20 @@ SOURCES += \
 HEADERS += \
     core/appstate.h \
     core/defines.h \
+    core/config/buildsizes.h \
     core/config/configuration.h \
+    core/config/sourcemap.h \
+    core/config/costmodel.h \
+    core/config/defineregistry.h \
+    core/config/definetable.h \
     core/config/settings.h \
     core/config/propfile.h \
     core/utilities/fileparse.h \
+    core/utilities/hash.h \
+    core/utilities/json.h \
     core/utilities/misc.h \
+    core/utilities/notifier.h \
+    core/utilities/ringbuffer.h \
     core/utilities/threadrunner.h \
     core/utilities/progress.h \
     editor/dialogs/bladearraydlg.h \
@@ -78,7 +112,26 @@ HEADERS += \
     mainmenu/mainmenu.h \
     onboard/onboard.h \
     tools/arduino.h \
+    tools/batchverify.h \
+    tools/boardwatch.h \
+    tools/builddirs.h \
+    tools/capturesearch.h \
+    tools/compileprogress.h \
+    tools/compilercache.h \
+    tools/dfureboot.h \
+    tools/faketoolchain.h \
+    tools/firmwarecache.h \
+    tools/flashstation.h \
+    tools/presetsync.h \
+    tools/process.h \
+    tools/serialcapture.h \
     tools/serialmonitor.h \
+    tools/serialwriter.h \
+    tools/sizedashboard.h \
+    tools/sketchoverlay.h \
+    tools/speculativebuild.h \
+    tools/toolchain.h \
+    ui/logview.h \
     ui/pccombobox.h \
     ui/pcspinctrl.h \
     ui/pcspinctrldouble.h \
@@ -3,9 +3,13 @@
 
 #include "core/appstate.h"
 #include "core/defines.h"
+#include "core/config/buildsizes.h"
+#include "core/config/costmodel.h"
 #include "core/utilities/fileparse.h"
 #include "onboard/onboard.h"
 #include "mainmenu/mainmenu.h"
+#include "tools/compilercache.h"
+#include "tools/toolchain.h"
 
 #include <fstream>
 #include <iostream>
@@ -15,6 +19,10 @@ AppState::AppState() {}
 void AppState::init() {
   instance = new AppState();
   instance->loadStateFromFile();
+  CostModel::init();
+  BuildSizes::init();
+  Toolchain::init();
+  CompilerCache::init();
 
   if (instance->firstRun) Onboard::instance = new Onboard();
   else MainMenu::instance = new MainMenu();
@@ -29,6 +37,10 @@ void AppState::saveState() {
   }
 
   stateFile << "FIRSTRUN: " << (firstRun ? "TRUE" : "FALSE") << std::endl;
+  stateFile << "CONFIGBYPROPERTY: " << (configByProperty ? "TRUE" : "FALSE") << std::endl;
+  stateFile << "SPECULATIVEBUILD: " << (speculativeBuild ? "TRUE" : "FALSE") << std::endl;
+  stateFile << "COMPILERCACHE: " << (compilerCache ? "TRUE" : "FALSE") << std::endl;
+  stateFile << "SERIALSCROLLBACK: " << serialScrollback << std::endl;
   stateFile << std::endl;
   stateFile << "PROPS {" << std::endl;
   for (const auto& prop : propFileNames) {
@@ -78,6 +90,11 @@ void AppState::loadStateFromFile() {
   stateFile.close();
 
   firstRun = FileParse::parseBoolEntry("FIRSTRUN", state);
+  configByProperty = FileParse::parseBoolEntry("CONFIGBYPROPERTY", state);
+  speculativeBuild = FileParse::parseBoolEntry("SPECULATIVEBUILD", state);
+  compilerCache = FileParse::parseBoolEntry("COMPILERCACHE", state);
+  auto scrollback = FileParse::parseNumEntry("SERIALSCROLLBACK", state);
+  if (scrollback > 0) serialScrollback = scrollback;
   auto tempProps = FileParse::extractSection("PROPS", state);
   for (std::string& prop : tempProps) {
     if (!(tmp = FileParse::parseLabel(prop)).empty()) propFileNames.push_back(tmp);
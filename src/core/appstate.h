@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -21,6 +22,14 @@ public:
   const std::vector<std::string>& getConfigFileNames();
 
   bool firstRun{true};
+  // Builds get CONFIG_FILE from a --build-property instead of a patched ProffieOS.ino
+  bool configByProperty{false};
+  // Saved configs are compiled in the background ahead of Apply/Verify
+  bool speculativeBuild{false};
+  // Compiles go through ccache, when it's installed
+  bool compilerCache{false};
+  // Lines the serial monitor keeps before dropping the oldest
+  int32_t serialScrollback{10000};
 
 private:
   AppState();
@@ -0,0 +1,118 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "core/config/buildsizes.h"
+
+#include "core/defines.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <locale>
+#include <sstream>
+
+// Per config and board; enough to go back through a good while of edits
+#define MAX_ENTRIES 100
+
+BuildSizes* BuildSizes::instance{nullptr};
+void BuildSizes::init() {
+  instance = new BuildSizes();
+  instance->loadHistory();
+}
+
+void BuildSizes::record(const std::string& config, const std::string& board, const CostModel::Usage& flash, const CostModel::Usage& ram) {
+  std::lock_guard<std::mutex> guard(lock);
+  auto& entries = history[{ config, board }];
+  entries.push_back({ std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count(), flash, ram });
+  if (entries.size() > MAX_ENTRIES) entries.erase(entries.begin(), entries.end() - MAX_ENTRIES);
+
+  saveHistory();
+}
+
+std::vector<BuildSizes::Entry> BuildSizes::getHistory(const std::string& config, const std::string& board) {
+  std::lock_guard<std::mutex> guard(lock);
+  auto entries = history.find({ config, board });
+  return entries == history.end() ? std::vector<Entry>{} : entries->second;
+}
+
+std::vector<std::string> BuildSizes::getBoards(const std::string& config) {
+  std::lock_guard<std::mutex> guard(lock);
+  std::vector<std::pair<int64_t, std::string>> boards;
+  for (const auto& [ key, entries ] : history) {
+    if (key.first == config && !entries.empty()) boards.emplace_back(entries.back().time, key.second);
+  }
+  std::sort(boards.begin(), boards.end(), [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+
+  std::vector<std::string> names;
+  for (const auto& [ time, board ] : boards) names.push_back(board);
+  return names;
+}
+
+std::string BuildSizes::describeLatest(const std::string& config, const std::string& board) {
+  auto entries = getHistory(config, board);
+  if (entries.empty()) return {};
+
+  std::ostringstream description;
+  description.imbue(std::locale::classic());
+  auto describe = [&](const char* name, CostModel::Usage BuildSizes::Entry::* usage) {
+    const auto& latest = entries.back().*usage;
+    description << name << ": " << latest.used << " of " << latest.max << " bytes";
+    if (latest.max) description << " (" << latest.used * 100 / latest.max << "%)";
+    if (entries.size() > 1) {
+      auto delta = static_cast<int64_t>(latest.used) - static_cast<int64_t>((entries[entries.size() - 2].*usage).used);
+      description << ", " << (delta >= 0 ? "+" : "") << delta << " since the last build";
+    }
+    description << '\n';
+  };
+  describe("Flash", &Entry::flash);
+  describe("RAM", &Entry::ram);
+
+  auto text = description.str();
+  text.pop_back();
+  return text;
+}
+
+void BuildSizes::loadHistory() {
+  std::ifstream historyFile(BUILDSIZES_PATH);
+  if (!historyFile.is_open()) return;
+
+  std::string line;
+  while (std::getline(historyFile, line)) {
+    std::vector<std::string> fields;
+    std::istringstream lineStream(line);
+    std::string field;
+    while (std::getline(lineStream, field, '\t')) fields.push_back(field);
+    if (fields.size() != 7) continue;
+
+    try {
+      Entry entry;
+      entry.time = std::stoll(fields[2]);
+      entry.flash = { static_cast<uint32_t>(std::stoul(fields[3])), static_cast<uint32_t>(std::stoul(fields[4])) };
+      entry.ram = { static_cast<uint32_t>(std::stoul(fields[5])), static_cast<uint32_t>(std::stoul(fields[6])) };
+      history[{ fields[0], fields[1] }].push_back(entry);
+    } catch (const std::exception&) {
+      std::cerr << "Skipping malformed build size entry..." << std::endl;
+    }
+  }
+}
+void BuildSizes::saveHistory() {
+  std::ofstream historyFile(BUILDSIZES_PATH ".tmp");
+  if (!historyFile.is_open()) {
+    std::cerr << "Error creating temporary build sizes file." << std::endl;
+    return;
+  }
+  historyFile.imbue(std::locale::classic());
+
+  for (const auto& [ key, entries ] : history) {
+    for (const auto& entry : entries) {
+      historyFile << key.first << '\t' << key.second << '\t' << entry.time << '\t' << entry.flash.used << '\t' << entry.flash.max << '\t' << entry.ram.used << '\t' << entry.ram.max << std::endl;
+    }
+  }
+  historyFile.close();
+
+  remove(BUILDSIZES_PATH);
+  if (rename(BUILDSIZES_PATH ".tmp", BUILDSIZES_PATH) != 0) {
+    std::cerr << "Error saving build sizes file." << std::endl;
+  }
+}
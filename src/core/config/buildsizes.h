@@ -0,0 +1,46 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include "core/config/costmodel.h"
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// The flash and RAM usage of every successful build, kept per config and board so it can be
+// followed over time (see SizeDashboard). Unlike the CostModel this never mixes configs together.
+class BuildSizes {
+public:
+  static void init();
+  static BuildSizes* instance;
+
+  struct Entry {
+    // Seconds since the epoch
+    int64_t time{0};
+    CostModel::Usage flash{};
+    CostModel::Usage ram{};
+  };
+
+  void record(const std::string& config, const std::string& board, const CostModel::Usage& flash, const CostModel::Usage& ram);
+  // Oldest first
+  std::vector<Entry> getHistory(const std::string& config, const std::string& board);
+  // Boards config has been built for, most recently built first
+  std::vector<std::string> getBoards(const std::string& config);
+  // The last build's usage and its change from the one before, for messages; empty if there's no history.
+  std::string describeLatest(const std::string& config, const std::string& board);
+
+private:
+  BuildSizes() = default;
+  BuildSizes(const BuildSizes&) = delete;
+
+  std::mutex lock{};
+  std::map<std::pair<std::string, std::string>, std::vector<Entry>> history{};
+
+  void loadHistory();
+  void saveHistory();
+};
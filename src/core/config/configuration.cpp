@@ -14,6 +14,7 @@
 #include "editor/pages/bladespage.h"
 #include "editor/dialogs/bladearraydlg.h"
 
+#include <algorithm>
 #include <cstring>
 #include <sstream>
 
@@ -33,11 +34,10 @@ bool Configuration::outputConfig(const std::string& filePath, EditorWindow* edit
 
   if (!runPreChecks(editor)) return false;
 
-  std::ofstream configOutput(filePath);
-  if (!configOutput.is_open()) {
-    ERR("Could not open config file for output.");
-  }
+  DefineTable defines;
+  if (!buildDefineTable(defines, editor)) return false;
 
+  std::ostringstream configOutput;
   configOutput <<
       "/*" << std::endl <<
       "This configuration file was generated by ProffieConfig " VERSION ", created by Ryryog25." << std::endl <<
@@ -45,12 +45,19 @@ bool Configuration::outputConfig(const std::string& filePath, EditorWindow* edit
       "ProffieConfig is an All-In-One utility for managing your Proffieboard." << std::endl <<
       "*/" << std::endl << std::endl;
 
-  outputConfigTop(configOutput, editor);
+  outputConfigTop(configOutput, editor, defines);
   outputConfigProp(configOutput, editor);
-  outputConfigPresets(configOutput, editor);
+  auto text = configOutput.str();
+  outputConfigPresets(configOutput, editor, static_cast<int32_t>(std::count(text.begin(), text.end(), '\n')) + 1);
   outputConfigButtons(configOutput, editor);
 
-  configOutput.close();
+  // Binary so line endings, and therefore the bytes, are the same on every platform
+  std::ofstream configFile(filePath, std::ios::binary);
+  if (!configFile.is_open()) {
+    ERR("Could not open config file for output.");
+  }
+  configFile << configOutput.str();
+  configFile.close();
   return true;
 }
 bool Configuration::outputConfig(EditorWindow* editor) { return Configuration::outputConfig(CONFIG_DIR + editor->getOpenConfig() + ".h", editor); }
@@ -62,32 +69,49 @@ bool Configuration::exportConfig(EditorWindow* editor) {
   return Configuration::outputConfig(configLocation.GetPath().ToStdString(), editor);
 }
 
-void Configuration::outputConfigTop(std::ofstream& configOutput, EditorWindow* editor) {
+void Configuration::outputConfigTop(std::ostream& configOutput, EditorWindow* editor, const DefineTable& defines) {
   configOutput << "#ifdef CONFIG_TOP" << std::endl;
   outputConfigTopGeneral(configOutput, editor);
-  outputConfigTopPropSpecific(configOutput, editor);
-  outputConfigTopCustom(configOutput, editor);
+  for (const auto& define : defines.getOutput()) {
+    configOutput << "#define " << define << std::endl;
+  }
   configOutput << "#endif" << std::endl << std::endl;
 
 }
-void Configuration::outputConfigTopGeneral(std::ofstream& configOutput, EditorWindow* editor) {
+void Configuration::outputConfigTopGeneral(std::ostream& configOutput, EditorWindow* editor) {
   if (editor->generalPage->massStorage->GetValue()) configOutput << "//PROFFIECONFIG ENABLE_MASS_STORAGE" << std::endl;
   if (editor->generalPage->webUSB->GetValue()) configOutput << "//PROFFIECONFIG ENABLE_WEBUSB" << std::endl;
 
   configOutput << findInVMap(Proffieboard, editor->generalPage->board->entry()->GetValue().ToStdString()).second << std::endl;
 
   configOutput << "const unsigned int maxLedsPerStrip = " << editor->generalPage->maxLEDs->entry()->GetValue() << ";" << std::endl;
-  configOutput << "#define ENABLE_AUDIO" << std::endl;
-  configOutput << "#define ENABLE_WS2811" << std::endl;
-  configOutput << "#define ENABLE_SD" << std::endl;
-  configOutput << "#define ENABLE_MOTION" << std::endl;
-  configOutput << "#define SHARED_POWER_PINS" << std::endl;
-
-  for (const auto& [ name, define ] : editor->settings->generalDefines) {
-    if (define->shouldOutput()) configOutput << "#define " << define->getOutput() << std::endl;
+}
+
+void Configuration::collectDefines(DefineTable& defines, EditorWindow* editor) {
+  addGeneralDefines(defines, editor);
+  addPropDefines(defines, editor);
+  addCustomDefines(defines, editor);
+}
+bool Configuration::buildDefineTable(DefineTable& defines, EditorWindow* editor) {
+  collectDefines(defines, editor);
+
+  if (defines.hasConflicts()) {
+    ERR("The following defines are set more than once with different values:\n\n" + defines.describeConflicts() + "\nPlease remove or change the duplicates.");
+  }
+  return true;
+}
+void Configuration::addGeneralDefines(DefineTable& defines, EditorWindow* editor) {
+  defines.add("ENABLE_AUDIO", DefineTable::Source::GENERAL);
+  defines.add("ENABLE_WS2811", DefineTable::Source::GENERAL);
+  defines.add("ENABLE_SD", DefineTable::Source::GENERAL);
+  defines.add("ENABLE_MOTION", DefineTable::Source::GENERAL);
+  defines.add("SHARED_POWER_PINS", DefineTable::Source::GENERAL);
+
+  for (const auto& define : editor->settings->getOutputDefines()) {
+    defines.add(define, DefineTable::Source::GENERAL);
   }
 }
-void Configuration::outputConfigTopPropSpecific(std::ofstream& configOutput, EditorWindow* editor) {
+void Configuration::addPropDefines(DefineTable& defines, EditorWindow* editor) {
   auto selectedProp = editor->propsPage->getSelectedProp();
   if (selectedProp == nullptr) return;
 
@@ -99,16 +123,16 @@ void Configuration::outputConfigTopPropSpecific(std::ofstream& configOutput, Edi
         ) continue;
 
     auto output = setting.getOutput();
-    if (!output.empty()) configOutput << "#define " << output << std::endl;
+    if (!output.empty()) defines.add(output, DefineTable::Source::PROP);
   }
 }
-void Configuration::outputConfigTopCustom(std::ofstream& configOutput, EditorWindow* editor) {
+void Configuration::addCustomDefines(DefineTable& defines, EditorWindow* editor) {
   for (const auto& [ name, value ] : editor->generalPage->customOptDlg->getCustomDefines()) {
-    configOutput << "#define " << name << " " << value << std::endl;
+    defines.add(name, value, DefineTable::Source::CUSTOM);
   }
 }
 
-void Configuration::outputConfigProp(std::ofstream& configOutput, EditorWindow* editor) {
+void Configuration::outputConfigProp(std::ostream& configOutput, EditorWindow* editor) {
   auto selectedProp = editor->propsPage->getSelectedProp();
   if (selectedProp == nullptr) return;
 
@@ -116,40 +140,59 @@ void Configuration::outputConfigProp(std::ofstream& configOutput, EditorWindow*
   configOutput << "#include \"../props/" << selectedProp->getFileName() << "\"" << std::endl;
   configOutput << "#endif" << std:: endl << std::endl; // CONFIG_PROP
 }
-void Configuration::outputConfigPresets(std::ofstream& configOutput, EditorWindow* editor) {
+void Configuration::outputConfigPresets(std::ostream& configOutput, EditorWindow* editor, int32_t firstLine) {
   configOutput << "#ifdef CONFIG_PRESETS" << std::endl;
-  outputConfigPresetsStyles(configOutput, editor);
+  outputConfigPresetsStyles(configOutput, editor, firstLine + 1);
   outputConfigPresetsBlades(configOutput, editor);
   configOutput << "#endif" << std::endl << std::endl;
 }
-void Configuration::outputConfigPresetsStyles(std::ofstream& configOutput, EditorWindow* editor) {
-  for (const BladeArrayDlg::BladeArray& bladeArray : editor->bladesPage->bladeArrayDlg->bladeArrays) {
-    configOutput << "Preset " << bladeArray.name << "[] = {" << std::endl;
-    for (const PresetsPage::PresetConfig& preset : bladeArray.presets) {
-      configOutput << "\t{ \"" << preset.dirs << "\", \"" << preset.track << "\"," << std::endl;
+void Configuration::outputConfigPresetsStyles(std::ostream& configOutput, EditorWindow* editor, int32_t firstLine) {
+  // Tracks where output is up to, for the source map
+  int32_t line{firstLine}, column{1};
+  auto write = [&](const std::string& text) {
+    configOutput << text;
+    for (const char chr : text) {
+      if (chr == '\n') {
+        line++;
+        column = 1;
+      } else column++;
+    }
+  };
+
+  editor->sourceMap.clear();
+  const auto& bladeArrays = editor->bladesPage->bladeArrayDlg->bladeArrays;
+  for (size_t arrayIdx = 0; arrayIdx < bladeArrays.size(); arrayIdx++) {
+    const BladeArrayDlg::BladeArray& bladeArray = bladeArrays[arrayIdx];
+    write("Preset " + bladeArray.name.ToStdString() + "[] = {\n");
+    for (size_t presetIdx = 0; presetIdx < bladeArray.presets.size(); presetIdx++) {
+      const PresetsPage::PresetConfig& preset = bladeArray.presets[presetIdx];
+      write("\t{ \"" + preset.dirs.ToStdString() + "\", \"" + preset.track.ToStdString() + "\",\n");
       if (preset.styles.size() > 0) {
-        for (const wxString& style : preset.styles) {
-          std::istringstream styleStream(style.ToStdString());
+        for (size_t styleIdx = 0; styleIdx < preset.styles.size(); styleIdx++) {
+          auto style = preset.styles[styleIdx].ToStdString();
+          editor->sourceMap.addStyle(arrayIdx, presetIdx, styleIdx, style, line, column + 2, "\t\t");
+
+          std::istringstream styleStream(style);
           std::string styleLine;
           while (!false) {
             std::getline(styleStream, styleLine);
-            configOutput << "\t\t" << styleLine;
+            write("\t\t" + styleLine);
             if (styleStream.eof()) {
-              configOutput << ",";
+              write(",");
               break;
-            } else configOutput << std::endl;
+            } else write("\n");
           }
         }
-      } else configOutput << "\t\t," << std::endl;
-      configOutput << "\t\t\"" << preset.name << "\"}";
+      } else write("\t\t,\n");
+      write("\t\t\"" + preset.name.ToStdString() + "\"}");
       // If not the last one, add comma
-      if (&bladeArray.presets[bladeArray.presets.size() - 1] != &preset) configOutput << ",";
-      configOutput << std::endl;
+      if (presetIdx != bladeArray.presets.size() - 1) write(",");
+      write("\n");
     }
-    configOutput << "};" << std::endl;
+    write("};\n");
   }
 }
-void Configuration::outputConfigPresetsBlades(std::ofstream& configOutput, EditorWindow* editor) {
+void Configuration::outputConfigPresetsBlades(std::ostream& configOutput, EditorWindow* editor) {
   configOutput << "BladeConfig blades[] = {" << std::endl;
   for (const BladeArrayDlg::BladeArray& bladeArray : editor->bladesPage->bladeArrayDlg->bladeArrays) {
     configOutput << "\t{ " << (bladeArray.name == "no_blade" ? "NO_BLADE" : std::to_string(bladeArray.value)) << "," << std::endl;
@@ -208,7 +251,7 @@ void Configuration::outputConfigPresetsBlades(std::ofstream& configOutput, Edito
   }
   configOutput << "};" << std::endl;
 }
-void Configuration::genWS281X(std::ofstream& configOutput, const BladesPage::BladeConfig& blade) {
+void Configuration::genWS281X(std::ostream& configOutput, const BladesPage::BladeConfig& blade) {
   wxString bladePin = blade.dataPin;
   wxString bladeColor = blade.type == BD_PIXELRGB || blade.useRGBWithWhite ? blade.colorType : [=](wxString colorType) -> wxString { colorType.replace(colorType.find("W"), 1, "w"); return colorType; }(blade.colorType);
 
@@ -218,7 +261,7 @@ void Configuration::genWS281X(std::ofstream& configOutput, const BladesPage::Bla
   }
   configOutput << ">>()";
 };
-void Configuration::genSubBlades(std::ofstream& configOutput, const BladesPage::BladeConfig& blade) {
+void Configuration::genSubBlades(std::ostream& configOutput, const BladesPage::BladeConfig& blade) {
   int32_t subNum{0};
   for (const auto& subBlade : blade.subBlades) {
     if (blade.useStride) {
@@ -247,7 +290,7 @@ void Configuration::genSubBlades(std::ofstream& configOutput, const BladesPage::
     subNum++;
   }
 }
-void Configuration::outputConfigButtons(std::ofstream& configOutput, EditorWindow* editor) {
+void Configuration::outputConfigButtons(std::ostream& configOutput, EditorWindow* editor) {
   configOutput << "#ifdef CONFIG_BUTTONS" << std::endl;
   configOutput << "Button PowerButton(BUTTON_POWER, powerButtonPin, \"pow\");" << std::endl;
   if (editor->generalPage->buttons->entry()->GetValue() >= 2) configOutput << "Button AuxButton(BUTTON_AUX, auxPin, \"aux\");" << std::endl;
@@ -351,7 +394,7 @@ void Configuration::readConfigTop(std::ifstream& file, EditorWindow* editor) {
 }
 void Configuration::setCustomDefines(EditorWindow* editor) {
   for (const auto& define : editor->settings->readDefines) {
-    auto key = Settings::ProffieDefine::parseKey(define);
+    auto key = Settings::parseKey(define);
     editor->generalPage->customOptDlg->addDefine(key.first, key.second);
   }
 }
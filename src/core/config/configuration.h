@@ -5,6 +5,7 @@
 
 #include "editor/pages/bladespage.h"
 #include "editor/editorwindow.h"
+#include "core/config/definetable.h"
 
 #include <string>
 #include <fstream>
@@ -21,6 +22,7 @@ public:
   static bool exportConfig(EditorWindow* editorWindow);
   static bool readConfig(const std::string&, EditorWindow* editorWindow);
   static bool importConfig(EditorWindow* editorWindow);
+  static void collectDefines(DefineTable&, EditorWindow*);
 
   typedef std::pair<const std::string, const std::string> MapPair;
   typedef std::vector<MapPair> VMap;
@@ -46,22 +48,26 @@ private:
 
   static bool runPreChecks(EditorWindow*);
 
-  static void outputConfigTop(std::ofstream&, EditorWindow*);
-  static void outputConfigTopGeneral(std::ofstream&, EditorWindow*);
-  static void outputConfigTopCustom(std::ofstream&, EditorWindow*);
-  static void outputConfigTopBladeAwareness(std::ofstream&, EditorWindow*);
-  static void outputConfigTopPropSpecific(std::ofstream&, EditorWindow*);
-  static void outputConfigTopSA22C(std::ofstream&, EditorWindow*);
-  static void outputConfigTopFett263(std::ofstream&, EditorWindow*);
-  static void outputConfigTopBC(std::ofstream&, EditorWindow*);
-  static void outputConfigTopCaiwyn(std::ofstream&, EditorWindow*);
-  static void outputConfigProp(std::ofstream&, EditorWindow*);
-  static void outputConfigPresets(std::ofstream&, EditorWindow*);
-  static void outputConfigPresetsStyles(std::ofstream&, EditorWindow*);
-  static void outputConfigPresetsBlades(std::ofstream&, EditorWindow*);
-  static void genWS281X(std::ofstream&, const BladesPage::BladeConfig&);
-  static void genSubBlades(std::ofstream&, const BladesPage::BladeConfig&);
-  static void outputConfigButtons(std::ofstream&, EditorWindow*);
+  static bool buildDefineTable(DefineTable&, EditorWindow*);
+  static void addGeneralDefines(DefineTable&, EditorWindow*);
+  static void addPropDefines(DefineTable&, EditorWindow*);
+  static void addCustomDefines(DefineTable&, EditorWindow*);
+
+  static void outputConfigTop(std::ostream&, EditorWindow*, const DefineTable&);
+  static void outputConfigTopGeneral(std::ostream&, EditorWindow*);
+  static void outputConfigTopBladeAwareness(std::ostream&, EditorWindow*);
+  static void outputConfigTopSA22C(std::ostream&, EditorWindow*);
+  static void outputConfigTopFett263(std::ostream&, EditorWindow*);
+  static void outputConfigTopBC(std::ostream&, EditorWindow*);
+  static void outputConfigTopCaiwyn(std::ostream&, EditorWindow*);
+  static void outputConfigProp(std::ostream&, EditorWindow*);
+  static void outputConfigPresets(std::ostream&, EditorWindow*, int32_t firstLine);
+  // Records where each style goes in the editor's SourceMap, so firstLine has to be the line output is at
+  static void outputConfigPresetsStyles(std::ostream&, EditorWindow*, int32_t firstLine);
+  static void outputConfigPresetsBlades(std::ostream&, EditorWindow*);
+  static void genWS281X(std::ostream&, const BladesPage::BladeConfig&);
+  static void genSubBlades(std::ostream&, const BladesPage::BladeConfig&);
+  static void outputConfigButtons(std::ostream&, EditorWindow*);
 
   static void readConfigTop(std::ifstream&, EditorWindow*);
   static void readConfigProp(std::ifstream&, EditorWindow*);
@@ -0,0 +1,251 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "core/config/costmodel.h"
+
+#include "core/defines.h"
+#include "core/config/configuration.h"
+#include "core/config/definetable.h"
+#include "core/config/propfile.h"
+#include "core/utilities/hash.h"
+#include "editor/editorwindow.h"
+#include "editor/pages/generalpage.h"
+#include "editor/pages/propspage.h"
+#include "editor/pages/bladespage.h"
+#include "editor/dialogs/bladearraydlg.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+// Keeps the fit small and the file bounded; old builds say little about the current ProffieOS anyway.
+#define MAX_HISTORY 200
+// Small ridge penalty, only there to split the cost between features that always appear together
+// (and keep the system solvable) without noticeably shrinking features that were seen a few times.
+#define RIDGE_PENALTY 0.01
+
+CostModel* CostModel::instance{nullptr};
+void CostModel::init() {
+  instance = new CostModel();
+  instance->loadHistory();
+  instance->refit();
+}
+
+bool CostModel::parseSizes(const std::string& compileOutput, Sample& sample) {
+  bool foundFlash{false};
+  bool foundRam{false};
+
+  std::istringstream output(compileOutput);
+  std::string line;
+  while (std::getline(output, line)) {
+    unsigned long used{0}, max{0};
+    const char* text = line.c_str();
+    if (const char* flashLine = std::strstr(text, "Sketch uses ")) {
+      const char* maxText = std::strstr(flashLine, "Maximum is ");
+      if (std::sscanf(flashLine, "Sketch uses %lu bytes", &used) == 1 && maxText && std::sscanf(maxText, "Maximum is %lu", &max) == 1) {
+        sample.flash = { static_cast<uint32_t>(used), static_cast<uint32_t>(max) };
+        foundFlash = true;
+      }
+    } else if (const char* ramLine = std::strstr(text, "Global variables use ")) {
+      const char* maxText = std::strstr(ramLine, "Maximum is ");
+      if (std::sscanf(ramLine, "Global variables use %lu bytes", &used) == 1 && maxText && std::sscanf(maxText, "Maximum is %lu", &max) == 1) {
+        sample.ram = { static_cast<uint32_t>(used), static_cast<uint32_t>(max) };
+        foundRam = true;
+      }
+    }
+  }
+
+  return foundFlash && foundRam;
+}
+
+std::vector<std::string> CostModel::getFeatures(EditorWindow* editor) {
+  auto hashStyle = [](const std::string& style) {
+    Hash hash;
+    for (const char chr : style) {
+      if (!std::isspace(static_cast<unsigned char>(chr))) hash.add(chr);
+    }
+    return hash.hex();
+  };
+
+  std::set<std::string> features;
+
+  DefineTable defines;
+  Configuration::collectDefines(defines, editor);
+  for (const auto& define : defines.getOutput()) {
+    features.insert("define:" + define.substr(0, define.find(' ')));
+  }
+
+  auto selectedProp = editor->propsPage->getSelectedProp();
+  features.insert("prop:" + (selectedProp == nullptr ? std::string("default") : selectedProp->getFileName()));
+
+  for (const auto& bladeArray : editor->bladesPage->bladeArrayDlg->bladeArrays) {
+    for (const auto& preset : bladeArray.presets) {
+      for (const auto& style : preset.styles) {
+        features.insert("style:" + hashStyle(style.ToStdString()));
+      }
+    }
+  }
+
+  return { features.begin(), features.end() };
+}
+std::string CostModel::getBoard(EditorWindow* editor) {
+  return editor->generalPage->board->entry()->GetValue().ToStdString();
+}
+
+void CostModel::record(const Sample& sample) {
+  std::lock_guard<std::mutex> guard(lock);
+  history.push_back(sample);
+  if (history.size() > MAX_HISTORY) history.erase(history.begin(), history.end() - MAX_HISTORY);
+
+  saveHistory();
+  refit();
+}
+
+CostModel::Estimate CostModel::estimate(const std::string& board, const std::vector<std::string>& features) {
+  std::lock_guard<std::mutex> guard(lock);
+  Estimate estimate;
+
+  const Sample* reference{nullptr};
+  for (const auto& sample : history) {
+    if (sample.board != board) continue;
+    reference = &sample;
+    estimate.samples++;
+  }
+  if (reference == nullptr) return estimate;
+
+  auto boardFeatures = features;
+  boardFeatures.push_back("board:" + board);
+
+  auto clamp = [](double value) { return static_cast<uint32_t>(std::max(0.0, std::round(value))); };
+  estimate.flash = { clamp(predict(flashFit, boardFeatures)), reference->flash.max };
+  estimate.ram = { clamp(predict(ramFit, boardFeatures)), reference->ram.max };
+  estimate.valid = true;
+  return estimate;
+}
+
+void CostModel::refit() {
+  flashFit = fitUsage(history, &Sample::flash);
+  ramFit = fitUsage(history, &Sample::ram);
+}
+
+CostModel::Fit CostModel::fitUsage(const std::vector<Sample>& samples, Usage Sample::* usage) {
+  Fit fit;
+  if (samples.empty()) return fit;
+
+  std::map<std::string, size_t> columns;
+  auto sampleFeatures = [](const Sample& sample) {
+    auto features = sample.features;
+    features.push_back("board:" + sample.board);
+    return features;
+  };
+  for (const auto& sample : samples) {
+    for (const auto& feature : sampleFeatures(sample)) columns.emplace(feature, 0);
+  }
+  // Column 0 is the intercept
+  size_t numColumns = 1;
+  for (auto& [ feature, column ] : columns) column = numColumns++;
+
+  // Normal equations (XᵀX + λI)w = Xᵀy, with the intercept left unpenalized
+  std::vector<std::vector<double>> matrix(numColumns, std::vector<double>(numColumns + 1, 0));
+  for (const auto& sample : samples) {
+    std::vector<size_t> active{0};
+    for (const auto& feature : sampleFeatures(sample)) active.push_back(columns[feature]);
+    for (const auto row : active) {
+      for (const auto column : active) matrix[row][column] += 1;
+      matrix[row][numColumns] += (sample.*usage).used;
+    }
+  }
+  for (size_t diag = 1; diag < numColumns; diag++) matrix[diag][diag] += RIDGE_PENALTY;
+
+  // Gaussian elimination with partial pivoting; the system is small and symmetric positive definite
+  for (size_t pivot = 0; pivot < numColumns; pivot++) {
+    size_t best = pivot;
+    for (size_t row = pivot + 1; row < numColumns; row++) {
+      if (std::fabs(matrix[row][pivot]) > std::fabs(matrix[best][pivot])) best = row;
+    }
+    std::swap(matrix[pivot], matrix[best]);
+    if (std::fabs(matrix[pivot][pivot]) < 1e-12) continue;
+
+    for (size_t row = 0; row < numColumns; row++) {
+      if (row == pivot) continue;
+      double factor = matrix[row][pivot] / matrix[pivot][pivot];
+      if (factor == 0) continue;
+      for (size_t column = pivot; column <= numColumns; column++) matrix[row][column] -= factor * matrix[pivot][column];
+    }
+  }
+  auto solution = [&](size_t column) { return std::fabs(matrix[column][column]) < 1e-12 ? 0 : matrix[column][numColumns] / matrix[column][column]; };
+
+  fit.intercept = solution(0);
+  double styleTotal{0};
+  int32_t styleCount{0};
+  for (const auto& [ feature, column ] : columns) {
+    fit.weights[feature] = solution(column);
+    if (feature.rfind("style:", 0) == 0) {
+      styleTotal += fit.weights[feature];
+      styleCount++;
+    }
+  }
+  if (styleCount) fit.unseenStyleWeight = styleTotal / styleCount;
+
+  return fit;
+}
+
+double CostModel::predict(const Fit& fit, const std::vector<std::string>& features) {
+  double prediction = fit.intercept;
+  for (const auto& feature : features) {
+    auto weight = fit.weights.find(feature);
+    if (weight != fit.weights.end()) prediction += weight->second;
+    else if (feature.rfind("style:", 0) == 0) prediction += fit.unseenStyleWeight;
+  }
+  return prediction;
+}
+
+void CostModel::loadHistory() {
+  std::ifstream historyFile(SIZEHISTORY_PATH);
+  if (!historyFile.is_open()) return;
+
+  std::string line;
+  while (std::getline(historyFile, line)) {
+    std::vector<std::string> fields;
+    std::istringstream lineStream(line);
+    std::string field;
+    while (std::getline(lineStream, field, '\t')) fields.push_back(field);
+    if (fields.size() < 5) continue;
+
+    try {
+      Sample sample;
+      sample.board = fields[0];
+      sample.flash = { static_cast<uint32_t>(std::stoul(fields[1])), static_cast<uint32_t>(std::stoul(fields[2])) };
+      sample.ram = { static_cast<uint32_t>(std::stoul(fields[3])), static_cast<uint32_t>(std::stoul(fields[4])) };
+      sample.features.assign(fields.begin() + 5, fields.end());
+      history.push_back(sample);
+    } catch (const std::exception&) {
+      std::cerr << "Skipping malformed size history entry..." << std::endl;
+    }
+  }
+}
+void CostModel::saveHistory() {
+  std::ofstream historyFile(SIZEHISTORY_PATH ".tmp");
+  if (!historyFile.is_open()) {
+    std::cerr << "Error creating temporary size history file." << std::endl;
+    return;
+  }
+
+  for (const auto& sample : history) {
+    historyFile << sample.board << '\t' << sample.flash.used << '\t' << sample.flash.max << '\t' << sample.ram.used << '\t' << sample.ram.max;
+    for (const auto& feature : sample.features) historyFile << '\t' << feature;
+    historyFile << std::endl;
+  }
+  historyFile.close();
+
+  remove(SIZEHISTORY_PATH);
+  if (rename(SIZEHISTORY_PATH ".tmp", SIZEHISTORY_PATH) != 0) {
+    std::cerr << "Error saving size history file." << std::endl;
+  }
+}
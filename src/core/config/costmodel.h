@@ -0,0 +1,65 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class EditorWindow;
+
+// Learns what each config feature (define, prop, style) costs in flash and RAM from the
+// size report of every successful compile, so the editor can estimate usage without compiling.
+class CostModel {
+public:
+  static void init();
+  static CostModel* instance;
+
+  struct Usage {
+    uint32_t used{0};
+    uint32_t max{0};
+  };
+  struct Sample {
+    std::string board{};
+    Usage flash{};
+    Usage ram{};
+    std::vector<std::string> features{};
+  };
+  struct Estimate {
+    bool valid{false};
+    Usage flash{};
+    Usage ram{};
+    int32_t samples{0};
+  };
+
+  static bool parseSizes(const std::string& compileOutput, Sample&);
+  static std::vector<std::string> getFeatures(EditorWindow*);
+  static std::string getBoard(EditorWindow*);
+
+  void record(const Sample&);
+  Estimate estimate(const std::string& board, const std::vector<std::string>& features);
+
+private:
+  CostModel() = default;
+  CostModel(const CostModel&) = delete;
+
+  struct Fit {
+    double intercept{0};
+    std::map<std::string, double> weights{};
+    double unseenStyleWeight{0};
+  };
+
+  std::mutex lock{};
+  std::vector<Sample> history{};
+  Fit flashFit{};
+  Fit ramFit{};
+
+  void loadHistory();
+  void saveHistory();
+  void refit();
+  static Fit fitUsage(const std::vector<Sample>&, Usage Sample::*);
+  static double predict(const Fit&, const std::vector<std::string>&);
+};
@@ -0,0 +1,99 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <tuple>
+
+// Declarative table of the general ProffieOS defines.
+//
+// Intentionally free of wx so headless tools can walk the same table; widget
+// bindings are resolved per-Field at compile time in settings.cpp.
+namespace DefineRegistry {
+  enum class Type {
+    STATE,
+    RADIO,
+    NUMERIC,
+    DECIMAL,
+    COMBO,
+    TEXT
+  };
+
+  enum class Field {
+    NUM_BLADES,
+    NUM_BUTTONS,
+    VOLUME,
+    CLASH_THRESHOLD_G,
+    SAVE_COLOR_CHANGE,
+    SAVE_PRESET,
+    SAVE_VOLUME,
+    SAVE_STATE,
+    ENABLE_SSD1306,
+    DISABLE_COLOR_CHANGE,
+    DISABLE_TALKIE,
+    DISABLE_BASIC_PARSER_STYLES,
+    DISABLE_DIAGNOSTIC_COMMANDS,
+    ORIENTATION,
+    PLI_OFF_TIME,
+    IDLE_OFF_TIME,
+    MOTION_TIMEOUT,
+    BLADE_DETECT_PIN,
+    BLADE_ID_CLASS,
+    ENABLE_POWER_FOR_ID,
+    BLADE_ID_SCAN_MILLIS,
+    BLADE_ID_TIMES,
+  };
+
+  // Formatters take the define name and the textual value, and return everything after "#define ".
+  typedef std::string (*Formatter)(std::string_view, const std::string&);
+  namespace Format {
+    inline std::string flag(std::string_view name, const std::string&) { return std::string(name); }
+    inline std::string value(std::string_view name, const std::string& value) { return std::string(name) + " " + value; }
+    inline std::string minutes(std::string_view name, const std::string& value) { return std::string(name) + " " + value + " * 60 * 1000"; }
+  }
+
+  template <Type TYPE, Field FIELD>
+  struct Define {
+    static constexpr Type type{TYPE};
+    static constexpr Field field{FIELD};
+
+    std::string_view name;
+    Formatter format;
+  };
+
+  inline constexpr auto GENERAL = std::make_tuple(
+      Define<Type::NUMERIC, Field::NUM_BLADES>{ "NUM_BLADES", Format::value },
+      Define<Type::NUMERIC, Field::NUM_BUTTONS>{ "NUM_BUTTONS", Format::value },
+      Define<Type::NUMERIC, Field::VOLUME>{ "VOLUME", Format::value },
+      Define<Type::DECIMAL, Field::CLASH_THRESHOLD_G>{ "CLASH_THRESHOLD_G", Format::value },
+      Define<Type::STATE, Field::SAVE_COLOR_CHANGE>{ "SAVE_COLOR_CHANGE", Format::flag },
+      Define<Type::STATE, Field::SAVE_PRESET>{ "SAVE_PRESET", Format::flag },
+      Define<Type::STATE, Field::SAVE_VOLUME>{ "SAVE_VOLUME", Format::flag },
+      Define<Type::STATE, Field::SAVE_STATE>{ "SAVE_STATE", Format::flag },
+
+      Define<Type::STATE, Field::ENABLE_SSD1306>{ "ENABLE_SSD1306", Format::flag },
+
+      Define<Type::STATE, Field::DISABLE_COLOR_CHANGE>{ "DISABLE_COLOR_CHANGE", Format::flag },
+      Define<Type::STATE, Field::DISABLE_TALKIE>{ "DISABLE_TALKIE", Format::flag },
+      Define<Type::STATE, Field::DISABLE_BASIC_PARSER_STYLES>{ "DISABLE_BASIC_PARSER_STYLES", Format::flag },
+      Define<Type::STATE, Field::DISABLE_DIAGNOSTIC_COMMANDS>{ "DISABLE_DIAGNOSTIC_COMMANDS", Format::flag },
+
+      Define<Type::COMBO, Field::ORIENTATION>{ "ORIENTATION", Format::value },
+      Define<Type::NUMERIC, Field::PLI_OFF_TIME>{ "PLI_OFF_TIME", Format::minutes },
+      Define<Type::NUMERIC, Field::IDLE_OFF_TIME>{ "IDLE_OFF_TIME", Format::minutes },
+      Define<Type::NUMERIC, Field::MOTION_TIMEOUT>{ "MOTION_TIMEOUT", Format::minutes },
+
+      Define<Type::TEXT, Field::BLADE_DETECT_PIN>{ "BLADE_DETECT_PIN", Format::value },
+      Define<Type::COMBO, Field::BLADE_ID_CLASS>{ "BLADE_ID_CLASS", Format::value },
+      Define<Type::STATE, Field::ENABLE_POWER_FOR_ID>{ "ENABLE_POWER_FOR_ID", Format::value },
+      Define<Type::NUMERIC, Field::BLADE_ID_SCAN_MILLIS>{ "BLADE_ID_SCAN_MILLIS", Format::value },
+      Define<Type::NUMERIC, Field::BLADE_ID_TIMES>{ "BLADE_ID_TIMES", Format::value }
+      );
+
+  template <typename FUNC>
+  constexpr void forEach(FUNC&& func) {
+    std::apply([&func](const auto&... define) { (func(define), ...); }, GENERAL);
+  }
+}
@@ -0,0 +1,84 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "core/config/definetable.h"
+
+#include <iomanip>
+#include <iostream>
+#include <locale>
+#include <sstream>
+
+static std::string trim(const std::string& input) {
+  constexpr const char* whitespace = " \t\r\n";
+  auto begin = input.find_first_not_of(whitespace);
+  if (begin == std::string::npos) return {};
+  auto end = input.find_last_not_of(whitespace);
+  return input.substr(begin, end - begin + 1);
+}
+
+void DefineTable::add(const std::string& _name, const std::string& _value, Source source) {
+  Entry entry{ trim(_name), trim(_value), source };
+  if (entry.name.empty()) {
+    std::cerr << "Skipping define with empty name from " << sourceName(source) << "..." << std::endl;
+    return;
+  }
+
+  auto existing = entries.find(entry.name);
+  if (existing == entries.end()) {
+    entries.emplace(entry.name, entry);
+    return;
+  }
+
+  if (existing->second.value == entry.value) {
+    std::cerr << "Define \"" << entry.name << "\" set by both " << sourceName(existing->second.source) << " and " << sourceName(source) << ", writing once..." << std::endl;
+    return;
+  }
+
+  conflicts.push_back({ existing->second, entry });
+}
+void DefineTable::add(const std::string& define, Source source) {
+  auto trimmed = trim(define);
+  auto split = trimmed.find_first_of(" \t");
+  if (split == std::string::npos) add(trimmed, "", source);
+  else add(trimmed.substr(0, split), trimmed.substr(split + 1), source);
+}
+
+bool DefineTable::hasConflicts() const { return !conflicts.empty(); }
+const std::vector<DefineTable::Conflict>& DefineTable::getConflicts() const { return conflicts; }
+std::string DefineTable::describeConflicts() const {
+  std::string description;
+  auto describeValue = [](const Entry& entry) { return entry.value.empty() ? std::string("(no value)") : "\"" + entry.value + "\""; };
+  for (const auto& conflict : conflicts) {
+    description += "\"" + conflict.existing.name + "\" is set to " + describeValue(conflict.existing) + " by " + sourceName(conflict.existing.source);
+    description += " and to " + describeValue(conflict.incoming) + " by " + sourceName(conflict.incoming.source) + ".\n";
+  }
+  return description;
+}
+
+std::vector<std::string> DefineTable::getOutput() const {
+  std::vector<std::string> output;
+  output.reserve(entries.size());
+  for (const auto& [ name, entry ] : entries) {
+    output.push_back(entry.value.empty() ? name : name + " " + entry.value);
+  }
+  return output;
+}
+
+std::string DefineTable::sourceName(Source source) {
+  switch (source) {
+    case Source::GENERAL:
+      return "General";
+    case Source::PROP:
+      return "Prop File";
+    case Source::CUSTOM:
+      return "Custom Options";
+  }
+
+  return {};
+}
+std::string DefineTable::formatDecimal(double value) {
+  std::ostringstream stream;
+  stream.imbue(std::locale::classic());
+  stream << std::fixed << std::setprecision(6) << value;
+  return stream.str();
+}
@@ -0,0 +1,47 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+// Every #define emitted into CONFIG_TOP goes through one of these per generation pass,
+// so the same define can't be written twice and output order doesn't depend on where it came from.
+class DefineTable {
+public:
+  enum class Source {
+    GENERAL,
+    PROP,
+    CUSTOM
+  };
+
+  struct Entry {
+    std::string name{};
+    std::string value{};
+    Source source{Source::GENERAL};
+  };
+  struct Conflict {
+    Entry existing;
+    Entry incoming;
+  };
+
+  void add(const std::string& name, const std::string& value, Source);
+  void add(const std::string& define, Source);
+
+  bool hasConflicts() const;
+  const std::vector<Conflict>& getConflicts() const;
+  std::string describeConflicts() const;
+
+  // "NAME VALUE" strings, sorted by name
+  std::vector<std::string> getOutput() const;
+
+  static std::string sourceName(Source);
+  // Locale-independent; std::to_string follows the C locale, which GTK sets from the environment.
+  static std::string formatDecimal(double);
+
+private:
+  std::map<std::string, Entry> entries{};
+  std::vector<Conflict> conflicts{};
+};
@@ -4,6 +4,7 @@
 #include "core/config/propfile.h"
 
 #include "core/defines.h"
+#include "core/config/definetable.h"
 #include "core/utilities/fileparse.h"
 #include "ui/pcspinctrl.h"
 #include "ui/pcspinctrldouble.h"
@@ -34,7 +35,7 @@ std::string PropFile::Setting::getOutput() const {
     case SettingType::NUMERIC:
       return define + " " + std::to_string(static_cast<pcSpinCtrl*>(control)->entry()->GetValue());
     case SettingType::DECIMAL:
-      return define + " " + std::to_string(static_cast<pcSpinCtrlDouble*>(control)->entry()->GetValue());
+      return define + " " + DefineTable::formatDecimal(static_cast<pcSpinCtrlDouble*>(control)->entry()->GetValue());
   }
 
   return {};
@@ -74,7 +75,7 @@ void PropFile::Setting::setValue(double value) const {
 }
 PropFile::SettingMap* PropFile::getSettings() { return settings; }
 const std::array<PropFile::ButtonArray, 4>* PropFile::getButtons() { return buttons; }
-bool PropFile::Setting::checkRequiredSatisfied(const std::unordered_map<std::string, Setting>& settings) const {
+bool PropFile::Setting::checkRequiredSatisfied(const SettingMap& settings) const {
   if (!requiredAny.empty()) {
     for (const auto& require : requiredAny) {
       auto key = settings.find(require);
@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 #include <array>
+#include <map>
 #include <unordered_map>
 #include <wx/sizer.h>
 #include <wx/checkbox.h>
@@ -30,7 +31,8 @@ class PropFile : public wxPanel {
 public:
   ~PropFile();
   struct Setting;
-  typedef std::unordered_map<std::string, Setting> SettingMap;
+  // Ordered so that anything walking the settings (output, enable/disable) does so in a canonical order.
+  typedef std::map<std::string, Setting> SettingMap;
   struct Button;
   typedef std::vector<std::pair<std::string, std::vector<Button>>> ButtonArray;
 
@@ -81,7 +83,7 @@ struct PropFile::Setting {
   void setValue(double) const;
   void enable(bool = true) const;
   std::string getOutput() const;
-  bool checkRequiredSatisfied(const std::unordered_map<std::string, Setting>&) const;
+  bool checkRequiredSatisfied(const SettingMap&) const;
 
   std::string name{};
   std::string define{};
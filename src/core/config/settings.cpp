@@ -4,256 +4,210 @@
 #include "core/config/settings.h"
 
 #include "core/config/configuration.h"
+#include "core/config/definetable.h"
 #include "editor/editorwindow.h"
 #include "editor/pages/generalpage.h"
+#include "editor/pages/bladespage.h"
 #include "editor/dialogs/bladearraydlg.h"
+#include "ui/pccombobox.h"
+#include "ui/pcspinctrl.h"
+#include "ui/pcspinctrldouble.h"
+#include "ui/pctextctrl.h"
 
+#include <algorithm>
 #include <cstring>
+#include <type_traits>
+#include <wx/checkbox.h>
+
+using DefineRegistry::Field;
+using DefineRegistry::Type;
+
+namespace {
+  template <Field FIELD>
+  auto element(EditorWindow* editor) {
+    if constexpr (FIELD == Field::NUM_BUTTONS) return editor->generalPage->buttons;
+    else if constexpr (FIELD == Field::VOLUME) return editor->generalPage->volume;
+    else if constexpr (FIELD == Field::CLASH_THRESHOLD_G) return editor->generalPage->clash;
+    else if constexpr (FIELD == Field::SAVE_COLOR_CHANGE) return editor->generalPage->colorSave;
+    else if constexpr (FIELD == Field::SAVE_PRESET) return editor->generalPage->presetSave;
+    else if constexpr (FIELD == Field::SAVE_VOLUME) return editor->generalPage->volumeSave;
+    else if constexpr (FIELD == Field::ENABLE_SSD1306) return editor->generalPage->enableOLED;
+    else if constexpr (FIELD == Field::DISABLE_COLOR_CHANGE) return editor->generalPage->disableColor;
+    else if constexpr (FIELD == Field::DISABLE_TALKIE) return editor->generalPage->noTalkie;
+    else if constexpr (FIELD == Field::DISABLE_BASIC_PARSER_STYLES) return editor->generalPage->noBasicParsers;
+    else if constexpr (FIELD == Field::DISABLE_DIAGNOSTIC_COMMANDS) return editor->generalPage->disableDiagnosticCommands;
+    else if constexpr (FIELD == Field::ORIENTATION) return editor->generalPage->orientation;
+    else if constexpr (FIELD == Field::PLI_OFF_TIME) return editor->generalPage->pliTime;
+    else if constexpr (FIELD == Field::IDLE_OFF_TIME) return editor->generalPage->idleTime;
+    else if constexpr (FIELD == Field::MOTION_TIMEOUT) return editor->generalPage->motionTime;
+    else if constexpr (FIELD == Field::BLADE_DETECT_PIN) return editor->bladesPage->bladeArrayDlg->detectPin;
+    else if constexpr (FIELD == Field::BLADE_ID_CLASS) return editor->bladesPage->bladeArrayDlg->mode;
+    else if constexpr (FIELD == Field::ENABLE_POWER_FOR_ID) return editor->bladesPage->bladeArrayDlg->enablePowerForID;
+    else if constexpr (FIELD == Field::BLADE_ID_SCAN_MILLIS) return editor->bladesPage->bladeArrayDlg->scanIDMillis;
+    else if constexpr (FIELD == Field::BLADE_ID_TIMES) return editor->bladesPage->bladeArrayDlg->numIDTimes;
+    else return nullptr; // NUM_BLADES and SAVE_STATE have no widget of their own
+  }
 
-Settings::Settings(EditorWindow* _parent) : parent(_parent) {
-  linkDefines();
-  setCustomInputParsers();
-  setCustomOutputParsers();
-}
-Settings::~Settings() {
-  for (const auto& define : generalDefines) delete define.second;
-}
-
-void Settings::linkDefines() {
-# define ENTRY(name, ...) { name, new ProffieDefine(name, __VA_ARGS__) }
-# define CHECKER(name) [&](const ProffieDefine* name) -> bool
-# define IDSETTING(setting) parent->bladesPage->bladeArrayDlg->setting->GetValue()
-
-  generalDefines = {
-                    // General
-                    ENTRY("NUM_BLADES", -1,( pcSpinCtrl*)nullptr, CHECKER(){ return true; }),
-                    ENTRY("NUM_BUTTONS", 2, parent->generalPage->buttons, CHECKER(){ return true; }),
-                    ENTRY("VOLUME", 1500, parent->generalPage->volume, CHECKER(){ return true; }),
-                    ENTRY("CLASH_THRESHOLD_G", 3.0, parent->generalPage->clash, CHECKER(){ return true; }),
-                    ENTRY("SAVE_COLOR_CHANGE", true, parent->generalPage->colorSave),
-                    ENTRY("SAVE_PRESET", true, parent->generalPage->presetSave),
-                    ENTRY("SAVE_VOLUME", true, parent->generalPage->volumeSave),
-                    ENTRY("SAVE_STATE", false, (wxCheckBox*)nullptr, CHECKER(){ return false; }),
-
-                    ENTRY("ENABLE_SSD1306", false, parent->generalPage->enableOLED),
-
-                    ENTRY("DISABLE_COLOR_CHANGE", false, parent->generalPage->disableColor),
-                    ENTRY("DISABLE_TALKIE", false, parent->generalPage->noTalkie),
-                    ENTRY("DISABLE_BASIC_PARSER_STYLES", true, parent->generalPage->noBasicParsers),
-                    ENTRY("DISABLE_DIAGNOSTIC_COMMANDS", true, parent->generalPage->disableDiagnosticCommands),
-
-                    ENTRY("ORIENTATION", Configuration::Orientation.begin()->first, parent->generalPage->orientation, CHECKER(){ return true; }),
-                    ENTRY("PLI_OFF_TIME", 2, parent->generalPage->pliTime, CHECKER(){ return true; }),
-                    ENTRY("IDLE_OFF_TIME", 15, parent->generalPage->idleTime, CHECKER(){ return true; }),
-                    ENTRY("MOTION_TIMEOUT", 10, parent->generalPage->motionTime, CHECKER(){ return true; }),
-
-                    ENTRY("BLADE_DETECT_PIN", "", parent->bladesPage->bladeArrayDlg->detectPin, CHECKER(){ return IDSETTING(enableDetect); }),
-                    ENTRY("BLADE_ID_CLASS", "", parent->bladesPage->bladeArrayDlg->mode, CHECKER(){ return IDSETTING(enableID); }),
-                    ENTRY("ENABLE_POWER_FOR_ID", false, parent->bladesPage->bladeArrayDlg->enablePowerForID, CHECKER(def){ return IDSETTING(enableID) && def->getState(); }),
-                    ENTRY("BLADE_ID_SCAN_MILLIS", 1000, parent->bladesPage->bladeArrayDlg->scanIDMillis, CHECKER(){ return IDSETTING(enableID) && IDSETTING(continuousScans); }),
-                    ENTRY("BLADE_ID_TIMES", 10, parent->bladesPage->bladeArrayDlg->numIDTimes, CHECKER(){ return IDSETTING(enableID) && IDSETTING(continuousScans); }),
-                    };
-
-# undef ENTRY
-# undef CHECKER
-# undef IDSETTING
-}
-
-void Settings::setCustomInputParsers() {
-  generalDefines["NUM_BLADES"]->overrideParser ([&](const ProffieDefine* def, const std::string& input) -> bool {
-    auto key = ProffieDefine::parseKey(input);
-    if (key.first != def->getName()) return false;
-
-    numBlades = std::stoi(key.second);
-    return true;
-  });
-  generalDefines["SAVE_STATE"]->overrideParser([&](const ProffieDefine* def, const std::string& input) -> bool {
-    auto key = ProffieDefine::parseKey(input);
-    if (key.first != def->getName()) return false;
-
-    parent->generalPage->colorSave->SetValue(true);
-    parent->generalPage->presetSave->SetValue(true);
-    parent->generalPage->volumeSave->SetValue(true);
-    return true;
-  });
-  generalDefines["ORIENTATION"]->overrideParser([&](const ProffieDefine* def, const std::string& input) -> bool {
-    auto key = ProffieDefine::parseKey(input);
-    if (key.first != def->getName()) return false;
+  bool getValue(wxCheckBox* element) { return element->GetValue(); }
+  int32_t getValue(pcSpinCtrl* element) { return element->entry()->GetValue(); }
+  double getValue(pcSpinCtrlDouble* element) { return element->entry()->GetValue(); }
+  std::string getValue(pcComboBox* element) { return element->entry()->GetValue().ToStdString(); }
+  std::string getValue(pcTextCtrl* element) { return element->entry()->GetValue().ToStdString(); }
+
+  void setValue(wxCheckBox* element, const std::string&) { element->SetValue(true); }
+  void setValue(pcSpinCtrl* element, const std::string& value) { element->entry()->SetValue(std::stoi(value)); }
+  void setValue(pcSpinCtrlDouble* element, const std::string& value) { element->entry()->SetValue(std::stod(value)); }
+  void setValue(pcComboBox* element, const std::string& value) { element->entry()->SetValue(value); }
+  void setValue(pcTextCtrl* element, const std::string& value) { element->entry()->SetValue(value); }
+
+  std::string toText(bool) { return {}; }
+  std::string toText(int32_t value) { return std::to_string(value); }
+  std::string toText(double value) { return DefineTable::formatDecimal(value); }
+  std::string toText(const std::string& value) { return value; }
+
+  template <Type TYPE, Field FIELD>
+  bool shouldOutput(EditorWindow* editor) {
+    auto bladeArrayDlg = editor->bladesPage->bladeArrayDlg;
+
+    if constexpr (FIELD == Field::SAVE_STATE) return false;
+    else if constexpr (FIELD == Field::BLADE_DETECT_PIN) return bladeArrayDlg->enableDetect->GetValue();
+    else if constexpr (FIELD == Field::BLADE_ID_CLASS) return bladeArrayDlg->enableID->GetValue();
+    else if constexpr (FIELD == Field::ENABLE_POWER_FOR_ID) return bladeArrayDlg->enableID->GetValue() && getValue(element<FIELD>(editor));
+    else if constexpr (FIELD == Field::BLADE_ID_SCAN_MILLIS || FIELD == Field::BLADE_ID_TIMES) return bladeArrayDlg->enableID->GetValue() && bladeArrayDlg->continuousScans->GetValue();
+    else if constexpr (TYPE == Type::STATE || TYPE == Type::RADIO) return getValue(element<FIELD>(editor));
+    else return true;
+  }
 
-    parent->generalPage->orientation->entry()->SetValue(Configuration::findInVMap(Configuration::Orientation, key.second).first);
-    return true;
-  });
-  generalDefines["ORIENTATION"]->overrideOutput([&](const ProffieDefine* def) -> std::string {
-    return {def->getName() + " " + Configuration::findInVMap(Configuration::Orientation, def->getString()).second};
-  });
-  generalDefines["BLADE_DETECT_PIN"]->overrideParser([&](const ProffieDefine* def, const std::string& input) -> bool {
-    auto key = ProffieDefine::parseKey(input);
-    if (key.first != def->getName()) return false;
-    
-    parent->bladesPage->bladeArrayDlg->enableDetect->SetValue(true);
-    parent->bladesPage->bladeArrayDlg->detectPin->entry()->SetValue(key.second);
-    return true;
-  });
-  generalDefines["BLADE_ID_CLASS"]->overrideParser([&](const ProffieDefine* def, const std::string& input) -> bool {
-    auto key = ProffieDefine::parseKey(input);
-    if (key.first != def->getName()) return false;
-    
-    parent->bladesPage->bladeArrayDlg->enableID->SetValue(true);
-    key.second = std::strtok(key.second.data(), "< ");
-    if (key.second == "SnapshotBladeID") {
-      parent->bladesPage->bladeArrayDlg->mode->entry()->SetValue(BLADE_ID_MODE_SNAPSHOT);
-      parent->bladesPage->bladeArrayDlg->IDPin->entry()->SetValue(std::strtok(nullptr, "<> "));
-    } else if (key.second == "ExternalPullupBladeID") {
-      parent->bladesPage->bladeArrayDlg->mode->entry()->SetValue(BLADE_ID_MODE_EXTERNAL);
-      parent->bladesPage->bladeArrayDlg->IDPin->entry()->SetValue(std::strtok(nullptr, "<, "));
-      parent->bladesPage->bladeArrayDlg->pullupResistance->entry()->SetValue(std::stod(std::strtok(nullptr, ",> ")));
-    } else if (key.second == "BridgedPullupBladeID") {
-      parent->bladesPage->bladeArrayDlg->mode->entry()->SetValue(BLADE_ID_MODE_BRIDGED);
-      parent->bladesPage->bladeArrayDlg->IDPin->entry()->SetValue(std::strtok(nullptr, "<, "));
-      parent->bladesPage->bladeArrayDlg->pullupPin->entry()->SetValue(std::strtok(nullptr, ",> "));
-    }
-    return true;
-  });
-  generalDefines["BLADE_ID_SCAN_MILLIS"]->overrideParser([&](const ProffieDefine* def, const std::string& input) ->bool {
-    auto key = ProffieDefine::parseKey(input);
-    if (key.first != def->getName()) return false;
-    
-    parent->bladesPage->bladeArrayDlg->scanIDMillis->entry()->SetValue(std::stoi(key.second));
-    parent->bladesPage->bladeArrayDlg->continuousScans->SetValue(true);
-    return true;
-  });
-  generalDefines["BLADE_ID_TIMES"]->overrideParser([&](const ProffieDefine* def, const std::string& input) ->bool {
-    auto key = ProffieDefine::parseKey(input);
-    if (key.first != def->getName()) return false;
-    
-    parent->bladesPage->bladeArrayDlg->numIDTimes->entry()->SetValue(std::stoi(key.second));
-    parent->bladesPage->bladeArrayDlg->continuousScans->SetValue(true);
-    return true;
-  });
-  generalDefines["ENABLE_POWER_FOR_ID"]->overrideParser([&](const ProffieDefine* def, const std::string& input) -> bool {
-    auto key = ProffieDefine::parseKey(input);
-    if (key.first != def->getName()) return false;
-    
-    parent->bladesPage->bladeArrayDlg->enablePowerForID->SetValue(true);
-    std::strtok(key.second.data(), "<");
-    char* pwrPinTest = std::strtok(nullptr, "<>, ");
-    while (pwrPinTest != nullptr) {
-      key.second = pwrPinTest;
-      if (key.second == "bladePowerPin1") parent->bladesPage->bladeArrayDlg->powerPin1->SetValue(true);
-      if (key.second == "bladePowerPin2") parent->bladesPage->bladeArrayDlg->powerPin2->SetValue(true);
-      if (key.second == "bladePowerPin3") parent->bladesPage->bladeArrayDlg->powerPin3->SetValue(true);
-      if (key.second == "bladePowerPin4") parent->bladesPage->bladeArrayDlg->powerPin4->SetValue(true);
-      if (key.second == "bladePowerPin5") parent->bladesPage->bladeArrayDlg->powerPin5->SetValue(true);
-      if (key.second == "bladePowerPin6") parent->bladesPage->bladeArrayDlg->powerPin6->SetValue(true);
+  template <Field FIELD>
+  std::string valueText(EditorWindow* editor) {
+    auto bladeArrayDlg = editor->bladesPage->bladeArrayDlg;
+
+    if constexpr (FIELD == Field::NUM_BLADES) {
+      int32_t numBlades = 0;
+      for (const BladesPage::BladeConfig& blade : bladeArrayDlg->bladeArrays[editor->bladesPage->bladeArray->entry()->GetSelection()].blades) numBlades += blade.subBlades.size() > 0 ? blade.subBlades.size() : 1;
+      return std::to_string(numBlades);
+    } else if constexpr (FIELD == Field::SAVE_STATE) {
+      return {};
+    } else if constexpr (FIELD == Field::ORIENTATION) {
+      return Configuration::findInVMap(Configuration::Orientation, getValue(element<FIELD>(editor))).second;
+    } else if constexpr (FIELD == Field::BLADE_ID_CLASS) {
+      auto mode = getValue(element<FIELD>(editor));
+      auto idPin = bladeArrayDlg->IDPin->entry()->GetValue().ToStdString();
+      if (mode == BLADE_ID_MODE_SNAPSHOT) return "SnapshotBladeID<" + idPin + ">";
+      if (mode == BLADE_ID_MODE_EXTERNAL) return "ExternalPullupBladeID<" + idPin + ", " + std::to_string(bladeArrayDlg->pullupResistance->entry()->GetValue()) + ">";
+      if (mode == BLADE_ID_MODE_BRIDGED) return "BridgedPullupBladeID<" + idPin + ", " + bladeArrayDlg->pullupPin->entry()->GetValue().ToStdString() + ">";
+      return {};
+    } else if constexpr (FIELD == Field::ENABLE_POWER_FOR_ID) {
+      std::string powerPins;
+      for (const auto& [ pin, name ] : {
+             std::pair{ bladeArrayDlg->powerPin1, "bladePowerPin1" },
+             std::pair{ bladeArrayDlg->powerPin2, "bladePowerPin2" },
+             std::pair{ bladeArrayDlg->powerPin3, "bladePowerPin3" },
+             std::pair{ bladeArrayDlg->powerPin4, "bladePowerPin4" },
+             std::pair{ bladeArrayDlg->powerPin5, "bladePowerPin5" },
+             std::pair{ bladeArrayDlg->powerPin6, "bladePowerPin6" },
+           }) {
+        if (!pin->GetValue()) continue;
+        if (!powerPins.empty()) powerPins += ",";
+        powerPins += name;
+      }
+      return "PowerPINS<" + powerPins + ">";
+    } else return toText(getValue(element<FIELD>(editor)));
+  }
 
-      pwrPinTest = std::strtok(nullptr, "<>, ");
+  template <Field FIELD>
+  void parseDefine(Settings& settings, EditorWindow* editor, std::string value) {
+    auto bladeArrayDlg = editor->bladesPage->bladeArrayDlg;
+
+    if constexpr (FIELD == Field::NUM_BLADES) {
+      settings.numBlades = std::stoi(value);
+    } else if constexpr (FIELD == Field::SAVE_STATE) {
+      editor->generalPage->colorSave->SetValue(true);
+      editor->generalPage->presetSave->SetValue(true);
+      editor->generalPage->volumeSave->SetValue(true);
+    } else if constexpr (FIELD == Field::ORIENTATION) {
+      setValue(element<FIELD>(editor), Configuration::findInVMap(Configuration::Orientation, value).first);
+    } else if constexpr (FIELD == Field::BLADE_DETECT_PIN) {
+      bladeArrayDlg->enableDetect->SetValue(true);
+      setValue(element<FIELD>(editor), value);
+    } else if constexpr (FIELD == Field::BLADE_ID_CLASS) {
+      bladeArrayDlg->enableID->SetValue(true);
+      value = std::strtok(value.data(), "< ");
+      if (value == "SnapshotBladeID") {
+        bladeArrayDlg->mode->entry()->SetValue(BLADE_ID_MODE_SNAPSHOT);
+        bladeArrayDlg->IDPin->entry()->SetValue(std::strtok(nullptr, "<> "));
+      } else if (value == "ExternalPullupBladeID") {
+        bladeArrayDlg->mode->entry()->SetValue(BLADE_ID_MODE_EXTERNAL);
+        bladeArrayDlg->IDPin->entry()->SetValue(std::strtok(nullptr, "<, "));
+        bladeArrayDlg->pullupResistance->entry()->SetValue(std::stod(std::strtok(nullptr, ",> ")));
+      } else if (value == "BridgedPullupBladeID") {
+        bladeArrayDlg->mode->entry()->SetValue(BLADE_ID_MODE_BRIDGED);
+        bladeArrayDlg->IDPin->entry()->SetValue(std::strtok(nullptr, "<, "));
+        bladeArrayDlg->pullupPin->entry()->SetValue(std::strtok(nullptr, ",> "));
+      }
+    } else if constexpr (FIELD == Field::ENABLE_POWER_FOR_ID) {
+      setValue(element<FIELD>(editor), value);
+      std::strtok(value.data(), "<");
+      char* pwrPinTest = std::strtok(nullptr, "<>, ");
+      while (pwrPinTest != nullptr) {
+        std::string pin = pwrPinTest;
+        if (pin == "bladePowerPin1") bladeArrayDlg->powerPin1->SetValue(true);
+        if (pin == "bladePowerPin2") bladeArrayDlg->powerPin2->SetValue(true);
+        if (pin == "bladePowerPin3") bladeArrayDlg->powerPin3->SetValue(true);
+        if (pin == "bladePowerPin4") bladeArrayDlg->powerPin4->SetValue(true);
+        if (pin == "bladePowerPin5") bladeArrayDlg->powerPin5->SetValue(true);
+        if (pin == "bladePowerPin6") bladeArrayDlg->powerPin6->SetValue(true);
+
+        pwrPinTest = std::strtok(nullptr, "<>, ");
+      }
+    } else if constexpr (FIELD == Field::BLADE_ID_SCAN_MILLIS || FIELD == Field::BLADE_ID_TIMES) {
+      setValue(element<FIELD>(editor), value);
+      bladeArrayDlg->continuousScans->SetValue(true);
+    } else {
+      setValue(element<FIELD>(editor), value);
     }
-    return true;
-  });
+  }
 }
-void Settings::setCustomOutputParsers() {
-  generalDefines["NUM_BLADES"]->overrideOutput([&](const ProffieDefine* def) -> std::string {
-    int32_t numBlades = 0;
-    for (const BladesPage::BladeConfig& blade : parent->bladesPage->bladeArrayDlg->bladeArrays[parent->bladesPage->bladeArray->entry()->GetSelection()].blades) numBlades += blade.subBlades.size() > 0 ? blade.subBlades.size() : 1;
-    return def->getName() + " " + std::to_string(numBlades);
-  });
-  generalDefines["PLI_OFF_TIME"]->overrideOutput([](const ProffieDefine* def) -> std::string {
-    return def->getName() + " " + std::to_string(def->getNum()) + " * 60 * 1000";
-  });
-  generalDefines["IDLE_OFF_TIME"]->overrideOutput([](const ProffieDefine* def) -> std::string {
-    return def->getName() + " " + std::to_string(def->getNum()) + " * 60 * 1000";
-  });
-  generalDefines["MOTION_TIMEOUT"]->overrideOutput([](const ProffieDefine* def) -> std::string {
-    return def->getName() + " " + std::to_string(def->getNum()) + " * 60 * 1000";
-  });
-  generalDefines["BLADE_ID_CLASS"]->overrideOutput([&](const ProffieDefine* def) -> std::string {
-    auto mode = parent->bladesPage->bladeArrayDlg->mode->entry()->GetValue();
-    std::string returnVal = def->getName() + " ";
-    if (mode == BLADE_ID_MODE_SNAPSHOT) returnVal + "SnapshotBladeID<" + parent->bladesPage->bladeArrayDlg->IDPin->entry()->GetValue() + ">";
-    else if (mode == BLADE_ID_MODE_BRIDGED) returnVal + "ExternalPullupBladeID<" + parent->bladesPage->bladeArrayDlg->IDPin->entry()->GetValue() + ", " + parent->bladesPage->bladeArrayDlg->pullupResistance->entry()->GetTextValue() + ">";
-    else if (mode == BLADE_ID_MODE_EXTERNAL) returnVal + "BridgedPullupBladeID<" + parent->bladesPage->bladeArrayDlg->IDPin->entry()->GetValue() + ", " + parent->bladesPage->bladeArrayDlg->pullupPin->entry()->GetValue();
-
-    return returnVal;
-  });
-  generalDefines["ENABLE_POWER_FOR_ID"]->overrideOutput([&](const ProffieDefine* def) -> std::string {
-    std::string returnVal = def->getName() + " PowerPINS<";
-    std::vector<std::string> powerPins;
-    if (parent->bladesPage->bladeArrayDlg->powerPin1->GetValue()) powerPins.push_back("bladePowerPin1");
-    if (parent->bladesPage->bladeArrayDlg->powerPin2->GetValue()) powerPins.push_back("bladePowerPin2");
-    if (parent->bladesPage->bladeArrayDlg->powerPin3->GetValue()) powerPins.push_back("bladePowerPin3");
-    if (parent->bladesPage->bladeArrayDlg->powerPin4->GetValue()) powerPins.push_back("bladePowerPin4");
-    if (parent->bladesPage->bladeArrayDlg->powerPin5->GetValue()) powerPins.push_back("bladePowerPin5");
-    if (parent->bladesPage->bladeArrayDlg->powerPin6->GetValue()) powerPins.push_back("bladePowerPin6");
 
-    for (int32_t pin = 0; pin < static_cast<int32_t>(powerPins.size()); pin++) {
-      returnVal += powerPins.at(pin);
-      if (pin < static_cast<int32_t>(powerPins.size()) -1) returnVal += ",";
-    }
-
-    returnVal += ">";
-    return returnVal;
-  });
-}
+Settings::Settings(EditorWindow* _parent) : parent(_parent) {}
 
 void Settings::parseDefines(std::vector<std::string>& _defList) {
-  for (const auto& [key, defObj] : generalDefines) {
-    for (auto entry = _defList.begin(); entry < _defList.end();) {
-      if (defObj->parseDefine(*entry)) {
-        _defList.erase(entry);
-        break;
-      }
-      auto key = ProffieDefine::parseKey(*entry);
-      if (
+  _defList.erase(std::remove_if(_defList.begin(), _defList.end(), [](const std::string& entry) {
+    auto key = parseKey(entry);
+    return
         key.first == "ENABLE_AUDIO" ||
         key.first == "ENABLE_WS2811" ||
         key.first == "ENABLE_SD" ||
         key.first == "ENABLE_MOTION" ||
-        key.first == "SHARED_POWER_PINS"
-        ) {
-        entry = _defList.erase(entry);
-        continue;
-      }
-      entry++;
-    }
-  }
-}
+        key.first == "SHARED_POWER_PINS";
+  }), _defList.end());
 
-int32_t Settings::ProffieDefine::getNum() const {
-  if (type != Type::NUMERIC) return 0;
-  return const_cast<pcSpinCtrl*>(static_cast<const pcSpinCtrl*>(element))->entry()->GetValue();
-}
-double Settings::ProffieDefine::getDec() const {
-  if (type != Type::DECIMAL) return 0;
-  return const_cast<pcSpinCtrlDouble*>(static_cast<const pcSpinCtrlDouble*>(element))->entry()->GetValue();
-}
-bool Settings::ProffieDefine::getState() const {
-  if (type == Type::STATE) return const_cast<wxCheckBox*>(static_cast<const wxCheckBox*>(element))->GetValue();
-  if (type == Type::RADIO) return const_cast<wxRadioButton*>(static_cast<const wxRadioButton*>(element))->GetValue();
+  DefineRegistry::forEach([&](const auto& define) {
+    constexpr auto field = std::decay_t<decltype(define)>::field;
 
-  return false;
-}
-std::string Settings::ProffieDefine::getString() const {
-  if (type == Type::TEXT) return const_cast<pcTextCtrl*>(static_cast<const pcTextCtrl*>(element))->entry()->GetValue().ToStdString();
-  if (type == Type::COMBO) return const_cast<pcComboBox*>(static_cast<const pcComboBox*>(element))->entry()->GetValue().ToStdString();
+    for (auto entry = _defList.begin(); entry < _defList.end(); entry++) {
+      auto key = parseKey(*entry);
+      if (key.first != define.name) continue;
 
-  return "";
+      parseDefine<field>(*this, parent, key.second);
+      _defList.erase(entry);
+      break;
+    }
+  });
 }
 
-Settings::ProffieDefine::ProffieDefine(std::string _name, int32_t _defaultValue, pcSpinCtrl* _element, std::function<bool(const ProffieDefine*)> _check, bool _loose) :
-                                                                                                                                                                        type(Type::NUMERIC), looseChecking(_loose), defaultValue({ .num = _defaultValue }), identifier(_name), element(_element), checkOutput(_check) {}
-Settings::ProffieDefine::ProffieDefine(std::string _name, double _defaultValue, pcSpinCtrlDouble* _element, std::function<bool(const ProffieDefine*)> _check, bool _loose) :
-                                                                                                                                                                             type(Type::DECIMAL), looseChecking(_loose), defaultValue({ .dec = _defaultValue }), identifier(_name), element(_element), checkOutput(_check) {}
-Settings::ProffieDefine::ProffieDefine(std::string _name, bool _defaultState, wxCheckBox* _element, std::function<bool(const ProffieDefine*)> _check, bool _loose) :
-                                                                                                                                                                     type(Type::STATE), looseChecking(_loose), defaultValue({ .state = _defaultState }), identifier(_name), element(_element), checkOutput(_check) {}
-Settings::ProffieDefine::ProffieDefine(std::string _name, bool _defaultState, wxRadioButton* _element, std::function<bool(const ProffieDefine*)> _check, bool _loose) :
-                                                                                                                                                                        type(Type::RADIO), looseChecking(_loose), defaultValue({ .state = _defaultState }), identifier(_name), element(_element), checkOutput(_check) {}
-Settings::ProffieDefine::ProffieDefine(std::string _name, wxString _defaultSelection, pcComboBox* _element, std::function<bool(const ProffieDefine*)> _check, bool _loose) :
-                                                                                                                                                                             type(Type::COMBO), looseChecking(_loose), defaultValue({ .str = _defaultSelection.ToStdString().data() }), identifier(_name), element(_element), checkOutput(_check) {}
-Settings::ProffieDefine::ProffieDefine(std::string _name, wxString _defaultEntry, pcTextCtrl* _element, std::function<bool(const ProffieDefine*)> _check, bool _loose) :
-                                                                                                                                                                         type(Type::TEXT), looseChecking(_loose), defaultValue({ .str = _defaultEntry.ToStdString().data() }), identifier(_name), element(_element), checkOutput(_check) {}
+std::vector<std::string> Settings::getOutputDefines() const {
+  std::vector<std::string> outputDefines;
+  DefineRegistry::forEach([&](const auto& define) {
+    constexpr auto type = std::decay_t<decltype(define)>::type;
+    constexpr auto field = std::decay_t<decltype(define)>::field;
 
+    if (shouldOutput<type, field>(parent)) outputDefines.push_back(define.format(define.name, valueText<field>(parent)));
+  });
+  return outputDefines;
+}
 
-std::pair<std::string, std::string> Settings::ProffieDefine::parseKey(const std::string& _input) {
+std::pair<std::string, std::string> Settings::parseKey(const std::string& _input) {
   std::pair<std::string, std::string> key;
   std::string parseVal = _input;
 
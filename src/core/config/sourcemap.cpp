@@ -0,0 +1,51 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "core/config/sourcemap.h"
+
+void SourceMap::clear() {
+  entries.clear();
+}
+
+void SourceMap::addStyle(int32_t bladeArray, int32_t preset, int32_t blade, const std::string& style, int32_t line, int32_t column, const std::string& indent) {
+  Entry entry{ bladeArray, preset, blade, {} };
+
+  int32_t styleLine{0};
+  for (size_t start = 0; start <= style.size();) {
+    auto end = style.find('\n', start);
+    if (end == std::string::npos) end = style.size();
+
+    entry.segments.push_back({ line, column, static_cast<int32_t>(end - start), styleLine, static_cast<int32_t>(start) });
+    line++;
+    column = static_cast<int32_t>(indent.size()) + 1;
+    styleLine++;
+    start = end + 1;
+  }
+
+  entries.push_back(entry);
+}
+
+bool SourceMap::resolve(int32_t line, int32_t column, Location& location) const {
+  // Several styles can share a line, the last one starting at or before the column is it.
+  // The end of a segment counts too, gcc likes to point just past a token.
+  const Entry* bestEntry{nullptr};
+  const Segment* bestSegment{nullptr};
+  for (const auto& entry : entries) {
+    for (const auto& segment : entry.segments) {
+      if (segment.line != line || segment.column > column || column > segment.column + segment.length) continue;
+      if (bestSegment == nullptr || segment.column > bestSegment->column) {
+        bestEntry = &entry;
+        bestSegment = &segment;
+      }
+    }
+  }
+  if (bestSegment == nullptr) return false;
+
+  location.bladeArray = bestEntry->bladeArray;
+  location.preset = bestEntry->preset;
+  location.blade = bestEntry->blade;
+  location.styleLine = bestSegment->styleLine;
+  location.styleColumn = column - bestSegment->column;
+  location.styleOffset = bestSegment->styleOffset + location.styleColumn;
+  return true;
+}
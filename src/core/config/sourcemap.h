@@ -0,0 +1,48 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Where each blade style landed in the generated config, so a compiler diagnostic's
+// line and column can be traced back to the exact style (and place in it) that caused it.
+class SourceMap {
+public:
+  struct Location {
+    int32_t bladeArray{-1};
+    int32_t preset{-1};
+    // Index into the preset's styles, the same order the presets page lists blades in
+    int32_t blade{-1};
+    // Character offset into the style text, and the (0-based) line and column that is in it
+    int32_t styleOffset{0};
+    int32_t styleLine{0};
+    int32_t styleColumn{0};
+  };
+
+  void clear();
+  // Records a style written starting at (1-based) `line` and `column`, with `indent` written before each following line.
+  void addStyle(int32_t bladeArray, int32_t preset, int32_t blade, const std::string& style, int32_t line, int32_t column, const std::string& indent);
+
+  // Takes a line and column as gcc reports them (1-based, one column per byte), false if no style covers them.
+  bool resolve(int32_t line, int32_t column, Location&) const;
+
+private:
+  struct Segment {
+    int32_t line{0};
+    int32_t column{0};
+    int32_t length{0};
+    int32_t styleLine{0};
+    int32_t styleOffset{0};
+  };
+  struct Entry {
+    int32_t bladeArray{-1};
+    int32_t preset{-1};
+    int32_t blade{-1};
+    std::vector<Segment> segments{};
+  };
+
+  std::vector<Entry> entries{};
+};
@@ -48,6 +48,15 @@
 
 #define SMALLBUTTONSIZE wxSize(30, 20)
 
+#define SPECULATIVEBUILD_DELAY 3000 // ms after a save before building it in the background
+#define DFUREBOOT_TIMEOUT 10000 // ms to wait for a rebooted board to show up as a DFU device
+#define SERIALMONITOR_BUFFER (4 * 1024 * 1024) // Bytes of serial input held for the UI before the board is held off
+#define SERIALMONITOR_COMMANDS 4096 // Commands waiting to be written to the board
+#define SERIALMONITOR_FRAME 16 // ms between serial monitor updates, about 60 a second
+#define SERIALCAPTURE_SEGMENT (16 * 1024 * 1024) // Bytes of a serial capture before starting a new file
+#define SERIALCAPTURE_SESSIONS 20 // Serial captures kept before the oldest are removed
+#define PRESETSYNC_TIMEOUT 5000 // ms without an answer before a preset change over serial is given up on
+
 #if defined(__WXMSW__)
 #define RESOURCES_PATH "resources\\"
 #define ARDUINO_PATH RESOURCES_PATH "arduino-cli\\arduino-cli.exe"
@@ -75,4 +84,12 @@
 #endif
 
 #define STATEFILE_PATH RESOURCES_PATH ".state.pconf"
+#define SIZEHISTORY_PATH RESOURCES_PATH ".sizehistory"
+#define BUILDSIZES_PATH RESOURCES_PATH ".buildsizes"
+#define BUILDDIRS_PATH RESOURCES_PATH ".builds"
+#define FIRMWARECACHE_PATH RESOURCES_PATH ".firmware"
+#define COMPILETIMES_PATH RESOURCES_PATH ".compiletimes"
+#define COMPILERCACHE_PATH RESOURCES_PATH ".ccache"
+#define FLASHSTATION_PATH RESOURCES_PATH ".flashstation"
+#define SERIALCAPTURE_PATH RESOURCES_PATH "captures"
 #define PROFFIEOS_PATH RESOURCES_PATH "ProffieOS"
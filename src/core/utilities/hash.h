@@ -0,0 +1,33 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// FNV-1a, used wherever a hash ends up on disk, since std::hash isn't guaranteed to be stable across runs.
+class Hash {
+public:
+  Hash& add(const void* data, size_t length) {
+    auto bytes = static_cast<const unsigned char*>(data);
+    for (size_t idx = 0; idx < length; idx++) {
+      state ^= bytes[idx];
+      state *= 0x100000001b3;
+    }
+    return *this;
+  }
+  Hash& add(const std::string& data) { return add(data.data(), data.size()); }
+  Hash& add(char data) { return add(&data, 1); }
+
+  uint64_t get() const { return state; }
+  std::string hex() const {
+    char hashStr[17];
+    std::snprintf(hashStr, sizeof(hashStr), "%016llx", static_cast<unsigned long long>(state));
+    return hashStr;
+  }
+
+private:
+  uint64_t state{0xcbf29ce484222325};
+};
@@ -0,0 +1,201 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "core/utilities/json.h"
+
+#include <cstdlib>
+#include <cstring>
+
+bool JSON::parse(const std::string& text, JSON& out) {
+  size_t pos{0};
+  out = {};
+  JSON value;
+  if (!parseValue(text, pos, value)) return false;
+  skipWhitespace(text, pos);
+  if (pos != text.size()) return false;
+
+  out = value;
+  return true;
+}
+
+const JSON& JSON::operator[](const std::string& key) const {
+  static const JSON null;
+  if (type != Type::OBJECT) return null;
+  for (size_t idx = 0; idx < keys.size(); idx++) {
+    if (keys[idx] == key) return values[idx];
+  }
+  return null;
+}
+const JSON& JSON::operator[](size_t idx) const {
+  static const JSON null;
+  if (type != Type::ARRAY || idx >= array.size()) return null;
+  return array[idx];
+}
+
+void JSON::skipWhitespace(const std::string& text, size_t& pos) {
+  while (pos < text.size() && std::strchr(" \t\r\n", text[pos]) && text[pos] != '\0') pos++;
+}
+
+bool JSON::parseValue(const std::string& text, size_t& pos, JSON& out) {
+  skipWhitespace(text, pos);
+  if (pos >= text.size()) return false;
+
+  auto matchLiteral = [&](const char* literal) {
+    auto length = std::strlen(literal);
+    if (text.compare(pos, length, literal) != 0) return false;
+    pos += length;
+    return true;
+  };
+
+  switch (text[pos]) {
+    case '{':
+      out.type = Type::OBJECT;
+      pos++;
+      skipWhitespace(text, pos);
+      if (pos < text.size() && text[pos] == '}') {
+        pos++;
+        return true;
+      }
+      while (true) {
+        std::string key;
+        skipWhitespace(text, pos);
+        if (!parseString(text, pos, key)) return false;
+        skipWhitespace(text, pos);
+        if (pos >= text.size() || text[pos++] != ':') return false;
+        JSON value;
+        if (!parseValue(text, pos, value)) return false;
+        out.keys.push_back(key);
+        out.values.push_back(value);
+
+        skipWhitespace(text, pos);
+        if (pos >= text.size()) return false;
+        if (text[pos] == ',') { pos++; continue; }
+        if (text[pos] == '}') { pos++; return true; }
+        return false;
+      }
+    case '[':
+      out.type = Type::ARRAY;
+      pos++;
+      skipWhitespace(text, pos);
+      if (pos < text.size() && text[pos] == ']') {
+        pos++;
+        return true;
+      }
+      while (true) {
+        JSON value;
+        if (!parseValue(text, pos, value)) return false;
+        out.array.push_back(value);
+
+        skipWhitespace(text, pos);
+        if (pos >= text.size()) return false;
+        if (text[pos] == ',') { pos++; continue; }
+        if (text[pos] == ']') { pos++; return true; }
+        return false;
+      }
+    case '"':
+      out.type = Type::STRING;
+      return parseString(text, pos, out.string);
+    case 't':
+      out.type = Type::BOOL;
+      out.boolean = true;
+      return matchLiteral("true");
+    case 'f':
+      out.type = Type::BOOL;
+      return matchLiteral("false");
+    case 'n':
+      return matchLiteral("null");
+    default: {
+      // strtod would follow the C locale's decimal point, JSON's is always '.'
+      auto begin = pos;
+      if (pos < text.size() && text[pos] == '-') pos++;
+      while (pos < text.size() && (std::isdigit(static_cast<unsigned char>(text[pos])) || std::strchr(".eE+-", text[pos]))) pos++;
+      if (begin == pos) return false;
+
+      double value{0}, fraction{0.1};
+      int32_t exponent{0}, exponentSign{1};
+      bool negative{false}, inFraction{false}, inExponent{false};
+      for (auto idx = begin; idx < pos; idx++) {
+        auto chr = text[idx];
+        if (chr == '-' && idx == begin) negative = true;
+        else if (inExponent && (chr == '-' || chr == '+')) exponentSign = chr == '-' ? -1 : 1;
+        else if (chr == 'e' || chr == 'E') inExponent = true;
+        else if (chr == '.') inFraction = true;
+        else if (inExponent) exponent = exponent * 10 + (chr - '0');
+        else if (inFraction) { value += (chr - '0') * fraction; fraction /= 10; }
+        else value = value * 10 + (chr - '0');
+      }
+      while (exponent-- > 0) value = exponentSign > 0 ? value * 10 : value / 10;
+
+      out.type = Type::NUMBER;
+      out.number = negative ? -value : value;
+      return true;
+    }
+  }
+}
+
+bool JSON::parseString(const std::string& text, size_t& pos, std::string& out) {
+  if (pos >= text.size() || text[pos] != '"') return false;
+  pos++;
+
+  auto appendUTF8 = [&](uint32_t codepoint) {
+    if (codepoint < 0x80) out += static_cast<char>(codepoint);
+    else if (codepoint < 0x800) {
+      out += static_cast<char>(0xC0 | (codepoint >> 6));
+      out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    } else if (codepoint < 0x10000) {
+      out += static_cast<char>(0xE0 | (codepoint >> 12));
+      out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+      out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    } else {
+      out += static_cast<char>(0xF0 | (codepoint >> 18));
+      out += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+      out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+      out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    }
+  };
+  auto parseHex = [&](uint32_t& codepoint) {
+    if (pos + 4 > text.size()) return false;
+    auto hex = text.substr(pos, 4);
+    char* end;
+    codepoint = std::strtoul(hex.c_str(), &end, 16);
+    pos += 4;
+    return end == hex.c_str() + 4;
+  };
+
+  while (pos < text.size()) {
+    auto chr = text[pos++];
+    if (chr == '"') return true;
+    if (chr != '\\') {
+      out += chr;
+      continue;
+    }
+
+    if (pos >= text.size()) return false;
+    switch (text[pos++]) {
+      case '"': out += '"'; break;
+      case '\\': out += '\\'; break;
+      case '/': out += '/'; break;
+      case 'b': out += '\b'; break;
+      case 'f': out += '\f'; break;
+      case 'n': out += '\n'; break;
+      case 'r': out += '\r'; break;
+      case 't': out += '\t'; break;
+      case 'u': {
+        uint32_t codepoint;
+        if (!parseHex(codepoint)) return false;
+        // Surrogate pair
+        if (codepoint >= 0xD800 && codepoint < 0xDC00 && text.compare(pos, 2, "\\u") == 0) {
+          pos += 2;
+          uint32_t low;
+          if (!parseHex(low)) return false;
+          codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+        }
+        appendUTF8(codepoint);
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+  return false;
+}
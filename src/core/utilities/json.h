@@ -0,0 +1,41 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Just enough JSON to read arduino-cli's --format json output.
+class JSON {
+public:
+  enum class Type {
+    NUL,
+    BOOL,
+    NUMBER,
+    STRING,
+    ARRAY,
+    OBJECT
+  };
+
+  // False (and `out` left null) if `text` isn't a single valid JSON value
+  static bool parse(const std::string& text, JSON& out);
+
+  Type type{Type::NUL};
+  bool boolean{false};
+  double number{0};
+  std::string string{};
+  std::vector<JSON> array{};
+  std::vector<std::string> keys{};
+  std::vector<JSON> values{};
+
+  // Missing keys/indices (or the wrong type) give a null value, so lookups can be chained.
+  const JSON& operator[](const std::string& key) const;
+  const JSON& operator[](size_t idx) const;
+  const std::string& str() const { return string; }
+
+private:
+  static bool parseValue(const std::string&, size_t&, JSON&);
+  static bool parseString(const std::string&, size_t&, std::string&);
+  static void skipWhitespace(const std::string&, size_t&);
+};
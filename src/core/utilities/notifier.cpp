@@ -0,0 +1,51 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "core/utilities/notifier.h"
+
+#ifndef __WXMSW__
+
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+Notifier::Notifier() {
+# ifdef __linux__
+  readFd = writeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+# else
+  int fds[2];
+  if (pipe(fds) != 0) return;
+  for (auto fd : fds) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+  }
+  readFd = fds[0];
+  writeFd = fds[1];
+# endif
+}
+
+Notifier::~Notifier() {
+  if (readFd >= 0) close(readFd);
+  if (writeFd >= 0 && writeFd != readFd) close(writeFd);
+}
+
+void Notifier::notify() {
+  // A full pipe or eventfd counter is already as notified as it gets
+# ifdef __linux__
+  uint64_t value{1};
+# else
+  char value{1};
+# endif
+  while (write(writeFd, &value, sizeof(value)) < 0 && errno == EINTR) {}
+}
+
+void Notifier::clear() {
+  char buffer[64];
+  while (read(readFd, buffer, sizeof(buffer)) > 0) {}
+}
+
+#endif
@@ -0,0 +1,29 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#ifndef __WXMSW__
+
+#include <cstdint>
+
+// A file descriptor another thread can poll() on alongside its own, to be woken without a timeout.
+// An eventfd on Linux, a pipe elsewhere. Notifications made before it's cleared are merged into one.
+class Notifier {
+public:
+  Notifier();
+  ~Notifier();
+  Notifier(const Notifier&) = delete;
+
+  // -1 if it couldn't be created
+  int32_t fd() const { return readFd; }
+  void notify();
+  // Call once woken, so the next poll() waits for the next notify()
+  void clear();
+
+private:
+  int32_t readFd{-1};
+  int32_t writeFd{-1};
+};
+
+#endif
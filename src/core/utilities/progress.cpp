@@ -16,7 +16,8 @@ void Progress::emitEvent(int8_t progress, wxString message) {
 }
 
 void Progress::handleEvent(ProgressEvent* event) {
-  if (event->progress > event->progDialog->GetValue() || (event->progDialog->lastWasPulse && event->progress != -1)) {
+  // Same value is let through so the message can change (e.g. compile ETA)
+  if ((event->progress != -1 && event->progress >= event->progDialog->GetValue()) || (event->progDialog->lastWasPulse && event->progress != -1)) {
     event->progDialog->lastWasPulse = false;
     event->progDialog->Update(event->progress, event->message);
   }
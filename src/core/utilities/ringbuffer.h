@@ -0,0 +1,82 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Fixed-size queue between exactly one producer thread and one consumer thread, with no locks.
+// Neither side ever waits on the other here; what to do when it's full or empty is up to the caller.
+template<typename T>
+class RingBuffer {
+public:
+  // Rounded up to a power of two
+  RingBuffer(size_t capacity) {
+    size_t size{1};
+    while (size < capacity) size <<= 1;
+    buffer.resize(size);
+    mask = size - 1;
+  }
+  RingBuffer(const RingBuffer&) = delete;
+
+  size_t capacity() const { return buffer.size(); }
+
+  // Producer side
+  size_t space() const {
+    return buffer.size() - (tail.load(std::memory_order_relaxed) - head.load(std::memory_order_acquire));
+  }
+  // Copies in as many as fit, returning how many that was
+  size_t write(const T* data, size_t count) {
+    auto end = tail.load(std::memory_order_relaxed);
+    count = std::min(count, buffer.size() - (end - head.load(std::memory_order_acquire)));
+
+    auto first = std::min(count, buffer.size() - (end & mask));
+    std::copy(data, data + first, buffer.begin() + (end & mask));
+    std::copy(data + first, data + count, buffer.begin());
+    tail.store(end + count, std::memory_order_release);
+    return count;
+  }
+  bool push(T&& item) {
+    auto end = tail.load(std::memory_order_relaxed);
+    if (end - head.load(std::memory_order_acquire) == buffer.size()) return false;
+
+    buffer[end & mask] = std::move(item);
+    tail.store(end + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side
+  size_t size() const {
+    return tail.load(std::memory_order_acquire) - head.load(std::memory_order_relaxed);
+  }
+  // Copies out up to `count`, returning how many there were
+  size_t read(T* data, size_t count) {
+    auto start = head.load(std::memory_order_relaxed);
+    count = std::min(count, tail.load(std::memory_order_acquire) - start);
+
+    auto first = std::min(count, buffer.size() - (start & mask));
+    std::copy(buffer.begin() + (start & mask), buffer.begin() + (start & mask) + first, data);
+    std::copy(buffer.begin(), buffer.begin() + (count - first), data + first);
+    head.store(start + count, std::memory_order_release);
+    return count;
+  }
+  bool pop(T& item) {
+    auto start = head.load(std::memory_order_relaxed);
+    if (start == tail.load(std::memory_order_acquire)) return false;
+
+    item = std::move(buffer[start & mask]);
+    head.store(start + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  std::vector<T> buffer{};
+  size_t mask{0};
+  // Both only ever count up; kept apart so the two threads aren't fighting over one cache line
+  alignas(64) std::atomic<size_t> head{0};
+  alignas(64) std::atomic<size_t> tail{0};
+};
@@ -10,11 +10,14 @@
 
 #include "core/config/settings.h"
 #include "core/config/configuration.h"
+#include "core/config/costmodel.h"
 #include "core/defines.h"
 #include "core/utilities/misc.h"
 #include "core/utilities/progress.h"
 
 #include "tools/arduino.h"
+#include "tools/sizedashboard.h"
+#include "tools/speculativebuild.h"
 
 #include <wx/event.h>
 #include <wx/combobox.h>
@@ -34,12 +37,20 @@
 #include <wx/menu.h>
 
 EditorWindow::EditorWindow(const std::string& _configName, wxWindow* parent) : wxFrame(parent, wxID_ANY, "ProffieConfig Editor - " + _configName, wxDefaultPosition, wxDefaultSize), openConfig(_configName) {
+  // First, since edits made while anything else is set up are reported to it
+  speculativeBuild = new SpeculativeBuild(this);
   createMenuBar();
   createPages();
   bindEvents();
   createToolTips();
   settings = new Settings(this);
 
+  CreateStatusBar(2);
+  const int32_t statusWidths[]{ -3, -2 };
+  SetStatusWidths(2, statusWidths);
+  sizeEstimateTimer = new wxTimer(this, ID_SizeEstimateTimer);
+  sizeEstimateTimer->Start(1000);
+
 # ifdef __WXMSW__
   SetIcon( wxICON(IDI_ICON1) );
   SetBackgroundColour(wxSystemSettings::GetColour(wxSYS_COLOUR_FRAMEBK));
@@ -47,7 +58,9 @@ EditorWindow::EditorWindow(const std::string& _configName, wxWindow* parent) : w
   sizer->SetMinSize(450, -1);
 }
 EditorWindow::~EditorWindow() {
+  delete speculativeBuild;
   delete settings;
+  delete sizeEstimateTimer;
 }
 
 void EditorWindow::bindEvents() {
@@ -62,13 +75,31 @@ void EditorWindow::bindEvents() {
     }
     event.Veto();
   });
+  Bind(wxEVT_TIMER, [&](wxTimerEvent&) { if (IsShown()) updateSizeEstimate(); }, ID_SizeEstimateTimer);
   Bind(Progress::EVT_UPDATE, [&](wxCommandEvent& event) { Progress::handleEvent((Progress::ProgressEvent*)&event); }, wxID_ANY);
   Bind(Misc::EVT_MSGBOX, [&](wxCommandEvent &event) {
       wxMessageDialog(this, ((Misc::MessageBoxEvent*)&event)->message, ((Misc::MessageBoxEvent*)&event)->caption, ((Misc::MessageBoxEvent*)&event)->style).ShowModal();
     }, wxID_ANY);
-  Bind(wxEVT_MENU, [&](wxCommandEvent&) { Configuration::outputConfig(CONFIG_DIR + openConfig + ".h", this); }, ID_SaveConfig);
+  Bind(wxEVT_MENU, [&](wxCommandEvent&) { if (Configuration::outputConfig(CONFIG_DIR + openConfig + ".h", this)) speculativeBuild->schedule(); }, ID_SaveConfig);
+
+  // Anything changed in the pages outdates a background build of the last save.
+  // Text controls also report values set by the pages themselves, so only the one being typed in counts.
+  auto outdateBuild = [&](wxCommandEvent& event) {
+    if (event.GetId() != ID_WindowSelect) speculativeBuild->cancel();
+    event.Skip();
+  };
+  Bind(wxEVT_TEXT, [=](wxCommandEvent& event) {
+    if (wxWindow::FindFocus() == event.GetEventObject()) outdateBuild(event);
+    else event.Skip();
+  });
+  Bind(wxEVT_SPINCTRL, outdateBuild);
+  Bind(wxEVT_SPINCTRLDOUBLE, outdateBuild);
+  Bind(wxEVT_CHECKBOX, outdateBuild);
+  Bind(wxEVT_RADIOBUTTON, outdateBuild);
+  Bind(wxEVT_COMBOBOX, outdateBuild);
   Bind(wxEVT_MENU, [&](wxCommandEvent&) { Configuration::exportConfig(this); }, ID_ExportConfig);
   Bind(wxEVT_MENU, [&](wxCommandEvent&) { Arduino::verifyConfig(this, this); }, ID_VerifyConfig);
+  Bind(wxEVT_MENU, [&](wxCommandEvent&) { SizeDashboard::show(MainMenu::instance, openConfig, CostModel::getBoard(this)); }, ID_SizeHistory);
 
 # if defined(__WXOSX__)
   Bind(wxEVT_MENU, [&](wxCommandEvent&) { wxLaunchDefaultBrowser(Misc::path + std::string("/" STYLEEDIT_PATH)); }, ID_StyleEditor);
@@ -97,6 +128,16 @@ void EditorWindow::bindEvents() {
         FULLUPDATEWINDOW(this);
   }, ID_WindowSelect);
 }
+void EditorWindow::jumpToStyle(const SourceMap::Location& location) {
+  Raise();
+
+  windowSelect->entry()->SetStringSelection("Presets And Styles");
+  wxCommandEvent pageChange(wxEVT_COMBOBOX, ID_WindowSelect);
+  GetEventHandler()->ProcessEvent(pageChange);
+
+  presetsPage->showStyle(location);
+}
+
 void EditorWindow::createToolTips() {
 }
 
@@ -109,6 +150,7 @@ void EditorWindow::createMenuBar() {
 
   wxMenu* tools = new wxMenu;
   tools->Append(ID_StyleEditor, "Style Editor...", "Open the ProffieOS style editor");
+  tools->Append(ID_SizeHistory, "Size History...", "See how this config's flash and RAM usage changed over its builds");
 
   wxMenuBar *menuBar = new wxMenuBar;
   menuBar->Append(file, "&File");
@@ -146,5 +188,21 @@ void EditorWindow::createPages() {
   SetSizerAndFit(sizer);
 }
 
+void EditorWindow::updateSizeEstimate() {
+  auto estimate = CostModel::instance->estimate(CostModel::getBoard(this), CostModel::getFeatures(this));
+
+  wxString status;
+  if (!estimate.valid || !estimate.flash.max || !estimate.ram.max) {
+    status = "No size data for this board yet, verify the config to start estimating.";
+  } else {
+    auto flashPercent = estimate.flash.used * 100.0 / estimate.flash.max;
+    auto ramPercent = estimate.ram.used * 100.0 / estimate.ram.max;
+    status = wxString::Format("Estimated Flash ~%.0f%%, RAM ~%.0f%% (from %d builds)", flashPercent, ramPercent, estimate.samples);
+    if (flashPercent >= 100 || ramPercent >= 100) status += " - Config likely won't fit!";
+    else if (flashPercent >= 95 || ramPercent >= 95) status += " - Close to the limit";
+  }
+
+  if (GetStatusBar()->GetStatusText() != status) SetStatusText(status);
+}
 
 const std::string& EditorWindow::getOpenConfig() { return openConfig; }
@@ -3,10 +3,12 @@
 
 #pragma once
 
+#include "core/config/sourcemap.h"
 #include "ui/pccombobox.h"
 
 #include <wx/frame.h>
 #include <wx/sizer.h>
+#include <wx/timer.h>
 
 // Forward declarations to get around circular dependencies
 class GeneralPage;
@@ -15,6 +17,7 @@ class BladesPage;
 class PresetsPage;
 class BladeArrayDlg;
 class Settings;
+class SpeculativeBuild;
 
 class EditorWindow : public wxFrame {
 public:
@@ -22,16 +25,22 @@ public:
   ~EditorWindow();
 
   const std::string& getOpenConfig();
+  // Brings up the presets page on the style at location, with the spot highlighted
+  void jumpToStyle(const SourceMap::Location&);
 
   GeneralPage* generalPage{nullptr};
   PropsPage* propsPage{nullptr};
   BladesPage* bladesPage{nullptr};
   PresetsPage* presetsPage{nullptr};
   Settings* settings{nullptr};
+  SpeculativeBuild* speculativeBuild{nullptr};
 
   wxBoxSizer* sizer{nullptr};
 
   pcComboBox* windowSelect{nullptr};
+  wxTimer* sizeEstimateTimer{nullptr};
+  // From the last time the config was written out
+  SourceMap sourceMap{};
 
   enum {
     ID_WindowSelect,
@@ -42,12 +51,17 @@ public:
     ID_VerifyConfig,
 
     ID_StyleEditor,
+    ID_SizeHistory,
+
+    ID_SizeEstimateTimer,
+    ID_SpeculativeBuildTimer,
   };
 private:
   void bindEvents();
   void createToolTips();
   void createMenuBar();
   void createPages();
+  void updateSizeEstimate();
 
   const std::string openConfig{};
 };
@@ -8,11 +8,19 @@
 #include "editor/editorwindow.h"
 #include "editor/dialogs/bladearraydlg.h"
 
+#include <algorithm>
 #include <string>
 #include <wx/tooltip.h>
 #ifdef __WXGTK__
 #include <wx/clipbrd.h>
 #endif
+#if defined(__WXOSX__) || defined(__WXGTK__)
+#include "tools/presetsync.h"
+#include "tools/serialmonitor.h"
+
+#include <wx/msgdlg.h>
+#include <wx/weakref.h>
+#endif
 
 PresetsPage::PresetsPage(wxWindow* window) : wxStaticBoxSizer(wxHORIZONTAL, window, ""), parent(static_cast<EditorWindow*>(window)) {
   styleInput = new pcTextCtrl(GetStaticBox(), ID_PresetChange, "", wxDefaultPosition, wxSize(400, 20), wxTE_MULTILINE);
@@ -82,6 +90,10 @@ void PresetsPage::bindEvents() {
         presetList->SetSelection(presetList->GetSelection() + 1);
         update();
       }, ID_MovePresetDown);
+# if defined(__WXOSX__) || defined(__WXGTK__)
+  GetStaticBox()->Bind(wxEVT_BUTTON, [&](wxCommandEvent&) { pushPresets(); }, ID_PushToBoard);
+  GetStaticBox()->Bind(wxEVT_BUTTON, [&](wxCommandEvent&) { syncPresets(); }, ID_SyncFromBoard);
+# endif
 }
 void PresetsPage::createToolTips() {
   TIP(nameInput, "The name for the preset.\nThis value is typically just for reference, and doesn't mean anything, but if using an OLED and without a special bitmap, this name will be displayed.\nUsing \"\\n\" is like hitting \"enter\" when the text is displayed on the OLED.\nFor example, \"my\\npreset\" will be displayed on the OLED as two lines, the first being \"my\" and the second being \"preset\".");
@@ -95,6 +107,11 @@ void PresetsPage::createToolTips() {
   TIP(addPreset, "Add a preset to the currently-selected blade array.");
   TIP(removePreset, "Delete the currently-selected preset.");
   
+# if defined(__WXOSX__) || defined(__WXGTK__)
+  TIP(pushToBoard, "Change the presets saved on the board's SD card to match these, without compiling or uploading.\nNames, font directories, tracks and style arguments are sent; changes to the styles themselves still need \"Apply Changes to Board\".\nThe board must be running this config, and connected through the Serial Monitor.");
+  TIP(syncFromBoard, "Replace the presets in the selected blade array with the ones saved on the board's SD card.\nThe board must be connected through the Serial Monitor.");
+# endif
+
   TIP(styleInput, "Your blade style goes here.\nThis is the code which sets up what animations and effects your blade (or other LED) will do.\nFor getting/creating blade styles, see the Documentation (in \"Help->Documentation...\").");
 }
 
@@ -154,6 +171,12 @@ wxBoxSizer* PresetsPage::createPresetConfig() {
   presetConfig->Add(dir);
   presetConfig->Add(track);
 
+# if defined(__WXOSX__) || defined(__WXGTK__)
+  pushToBoard = new wxButton(GetStaticBox(), ID_PushToBoard, "Push to Board");
+  syncFromBoard = new wxButton(GetStaticBox(), ID_SyncFromBoard, "Sync from Board");
+  presetConfig->Add(pushToBoard, wxSizerFlags(0).Border(wxLEFT | wxTOP, 10).Expand());
+  presetConfig->Add(syncFromBoard, wxSizerFlags(0).Border(wxLEFT | wxTOP, 10).Expand());
+# endif
 
   return presetConfig;
 }
@@ -173,6 +196,28 @@ void PresetsPage::update() {
 
   updateFields();
 }
+void PresetsPage::showStyle(const SourceMap::Location& location) {
+  if (location.bladeArray < 0 || location.bladeArray >= static_cast<int32_t>(bladeArray->entry()->GetCount())) return;
+  bladeArray->entry()->SetSelection(location.bladeArray);
+  parent->bladesPage->bladeArray->entry()->SetSelection(location.bladeArray);
+  update();
+
+  if (location.preset >= static_cast<int32_t>(presetList->GetCount()) || location.blade >= static_cast<int32_t>(bladeList->GetCount())) return;
+  presetList->SetSelection(location.preset);
+  bladeList->SetSelection(location.blade);
+  updateFields();
+
+  // The whole identifier or number gcc pointed at, or at least the one character
+  auto style = styleInput->entry()->GetValue();
+  long start = std::min<long>(location.styleOffset, style.size());
+  long end = start;
+  while (end < static_cast<long>(style.size()) && (wxIsalnum(style[end]) || style[end] == '_')) end++;
+  if (end == start && end < static_cast<long>(style.size())) end++;
+
+  styleInput->entry()->SetFocus();
+  styleInput->entry()->SetSelection(start, end);
+  styleInput->entry()->ShowPosition(start);
+}
 void PresetsPage::pushIfNewPreset() {
   if (presetList->GetSelection() == -1 && parent->bladesPage->bladeArrayDlg->bladeArrays[bladeArray->entry()->GetSelection()].blades.size() > 0 && (!nameInput->entry()->IsEmpty() || !dirInput->entry()->IsEmpty() || !trackInput->entry()->IsEmpty())) {
     parent->bladesPage->bladeArrayDlg->bladeArrays[bladeArray->entry()->GetSelection()].presets.push_back(PresetConfig());
@@ -314,3 +359,92 @@ void PresetsPage::stripAndSaveTrack() {
     trackInput->entry()->SetInsertionPoint(1);
   }
 }
+
+#if defined(__WXOSX__) || defined(__WXGTK__)
+void PresetsPage::pushPresets() {
+  if (!SerialMonitor::instance) {
+    wxMessageDialog(parent, "Open the Serial Monitor for the board first, presets are changed through its connection.", "Push to Board", wxOK | wxICON_ERROR).ShowModal();
+    return;
+  }
+
+  // Saved presets can only use the styles compiled in, with different arguments
+  std::vector<PresetSync::Preset> wanted;
+  const auto& presets = parent->bladesPage->bladeArrayDlg->bladeArrays[bladeArray->entry()->GetSelection()].presets;
+  for (size_t preset = 0; preset < presets.size(); preset++) {
+    PresetSync::Preset boardPreset{ presets[preset].name.ToStdString(), presets[preset].dirs.ToStdString(), presets[preset].track.ToStdString() };
+    for (size_t blade = 0; blade < presets[preset].styles.size(); blade++) {
+      boardPreset.styles.push_back(PresetSync::builtin(preset, blade, PresetSync::getStyleArgs(presets[preset].styles[blade].ToStdString())));
+    }
+    wanted.push_back(boardPreset);
+  }
+
+  // Only what's different from what's on the board is sent
+  wxWeakRef<EditorWindow> editor{parent};
+  auto& sync = SerialMonitor::instance->getPresetSync();
+  sync.list([editor, wanted, &sync](const std::vector<PresetSync::Preset>& board, const std::string& error) {
+    if (!error.empty()) {
+      if (editor) wxMessageDialog(editor, error, "Push to Board", wxOK | wxICON_ERROR).ShowModal();
+      return;
+    }
+    auto changes = PresetSync::diff(board, wanted).size();
+    sync.push(board, wanted, [editor, changes](const std::string& error) {
+      if (!editor) return;
+      if (!error.empty()) wxMessageDialog(editor, error, "Push to Board", wxOK | wxICON_ERROR).ShowModal();
+      else if (!changes) wxMessageDialog(editor, "The presets on the board already match.", "Push to Board", wxOK | wxICON_INFORMATION).ShowModal();
+      else wxMessageDialog(editor, "Presets updated on the board.", "Push to Board", wxOK | wxICON_INFORMATION).ShowModal();
+    });
+  });
+}
+
+void PresetsPage::syncPresets() {
+  if (!SerialMonitor::instance) {
+    wxMessageDialog(parent, "Open the Serial Monitor for the board first, presets are read through its connection.", "Sync from Board", wxOK | wxICON_ERROR).ShowModal();
+    return;
+  }
+
+  wxWeakRef<EditorWindow> editor{parent};
+  auto arrayIdx = bladeArray->entry()->GetSelection();
+  SerialMonitor::instance->getPresetSync().list([this, editor, arrayIdx](const std::vector<PresetSync::Preset>& board, const std::string& error) {
+    if (!editor) return;
+    if (!error.empty()) {
+      wxMessageDialog(editor, error, "Sync from Board", wxOK | wxICON_ERROR).ShowModal();
+      return;
+    }
+    if (arrayIdx >= static_cast<int32_t>(parent->bladesPage->bladeArrayDlg->bladeArrays.size())) return;
+    auto& presets = parent->bladesPage->bladeArrayDlg->bladeArrays[arrayIdx].presets;
+    if (wxMessageDialog(editor, wxString::Format("Replace the %d presets in \"%s\" with the %d on the board?", static_cast<int32_t>(presets.size()), parent->bladesPage->bladeArrayDlg->bladeArrays[arrayIdx].name, static_cast<int32_t>(board.size())), "Sync from Board", wxYES_NO | wxICON_QUESTION).ShowModal() != wxID_YES) return;
+
+    // The board's builtin styles are these ones, as last uploaded
+    const auto compiled = presets;
+    std::vector<PresetConfig> synced;
+    int32_t unmatched{0};
+    for (const auto& boardPreset : board) {
+      PresetConfig preset;
+      preset.name = wxString::FromUTF8(boardPreset.name);
+      preset.name.Replace("\n", "\\n");
+      preset.dirs = wxString::FromUTF8(boardPreset.font);
+      preset.track = wxString::FromUTF8(boardPreset.track);
+
+      for (size_t blade = 0; blade < boardPreset.styles.size(); blade++) {
+        size_t stylePreset, styleBlade;
+        std::string args;
+        if (PresetSync::parseBuiltin(boardPreset.styles[blade], stylePreset, styleBlade, args) && stylePreset < compiled.size() && styleBlade < compiled[stylePreset].styles.size()) {
+          preset.styles.push_back(PresetSync::setStyleArgs(compiled[stylePreset].styles[styleBlade].ToStdString(), args));
+          continue;
+        }
+
+        // Not one this config has, so whatever was in this spot stays
+        unmatched++;
+        if (synced.size() < compiled.size() && blade < compiled[synced.size()].styles.size()) preset.styles.push_back(compiled[synced.size()].styles[blade]);
+        else break;
+      }
+      synced.push_back(preset);
+    }
+
+    presets = synced;
+    parent->bladesPage->update();
+    update();
+    if (unmatched) wxMessageDialog(editor, std::to_string(unmatched) + " blade styles on the board are not built into this config, and were left as they were in the editor.", "Sync from Board", wxOK | wxICON_WARNING).ShowModal();
+  });
+}
+#endif
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "core/config/sourcemap.h"
 #include "editor/editorwindow.h"
 #include "ui/pctextctrl.h"
 
@@ -20,6 +21,8 @@ public:
   PresetsPage(wxWindow*);
 
   void update();
+  // Selects the location's blade array, preset and blade, and highlights the token at its offset in the style
+  void showStyle(const SourceMap::Location&);
 
   pcComboBox* bladeArray{nullptr};
   pcTextCtrl* styleInput{nullptr};
@@ -35,6 +38,9 @@ public:
   pcTextCtrl* dirInput{nullptr};
   pcTextCtrl* trackInput{nullptr};
 
+  wxButton* pushToBoard{nullptr};
+  wxButton* syncFromBoard{nullptr};
+
   struct PresetConfig {
     std::vector<wxString> styles{};
     wxString name{""};
@@ -50,7 +56,9 @@ public:
     ID_AddPreset,
     ID_RemovePreset,
     ID_MovePresetUp,
-    ID_MovePresetDown
+    ID_MovePresetDown,
+    ID_PushToBoard,
+    ID_SyncFromBoard
   };
 
 private:
@@ -73,4 +81,10 @@ private:
   void stripAndSaveName();
   void stripAndSaveDir();
   void stripAndSaveTrack();
+
+# if defined(__WXOSX__) || defined(__WXGTK__)
+  // Through the serial monitor's connection, for the selected blade array
+  void pushPresets();
+  void syncPresets();
+# endif
 };
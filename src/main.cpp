@@ -2,6 +2,7 @@
 // Copyright (C) 2024 Ryan Ogurek
 
 #include "core/appstate.h"
+#include "tools/boardwatch.h"
 
 #include <wx/app.h>
 
@@ -24,6 +25,11 @@ public:
 
     return true;
   }
+
+  virtual int OnExit() override {
+    BoardWatch::stop();
+    return wxApp::OnExit();
+  }
 };
 
 wxIMPLEMENT_APP(ProffieConfig);
@@ -11,7 +11,12 @@
 #include "onboard/onboard.h"
 #include "mainmenu/dialogs/addconfig.h"
 #include "tools/arduino.h"
+#include "tools/batchverify.h"
+#include "tools/boardwatch.h"
+#include "tools/compilercache.h"
+#include "tools/flashstation.h"
 #include "tools/serialmonitor.h"
+#include "tools/sizedashboard.h"
 #include "../resources/icons/icon-small.xpm"
 
 #include "ui/pccombobox.h"
@@ -37,6 +42,9 @@ MainMenu::MainMenu(wxWindow* parent) : wxFrame(parent, wxID_ANY, "ProffieConfig"
   createTooltips();
   bindEvents();
   update();
+  // Warm up now so the first refresh doesn't have to wait on discovery
+  BoardWatch::addListener(this);
+  BoardWatch::start();
 
 # ifdef __WXMSW__
   SetIcon( wxICON(IDI_ICON1) );
@@ -45,6 +53,9 @@ MainMenu::MainMenu(wxWindow* parent) : wxFrame(parent, wxID_ANY, "ProffieConfig"
 
   Show(true);
 }
+MainMenu::~MainMenu() {
+  BoardWatch::removeListener(this);
+}
 
 void MainMenu::bindEvents() {
   Bind(wxEVT_CLOSE_WINDOW, [&](wxCloseEvent& event) {
@@ -86,8 +97,18 @@ void MainMenu::bindEvents() {
     ID_Copyright);
   Bind(wxEVT_MENU, [&](wxCommandEvent&) { wxLaunchDefaultBrowser("https://github.com/Ryryog25/ProffieConfig/blob/master/docs"); }, ID_Docs);
   Bind(wxEVT_MENU, [&](wxCommandEvent&) { wxLaunchDefaultBrowser("https://github.com/Ryryog25/ProffieConfig/issues/new"); }, ID_Issue);
+  Bind(wxEVT_MENU, [&](wxCommandEvent& event) { AppState::instance->configByProperty = event.IsChecked(); AppState::instance->saveState(); }, ID_ConfigByProperty);
+  Bind(wxEVT_MENU, [&](wxCommandEvent& event) { AppState::instance->speculativeBuild = event.IsChecked(); AppState::instance->saveState(); }, ID_SpeculativeBuild);
+  Bind(wxEVT_MENU, [&](wxCommandEvent& event) { AppState::instance->compilerCache = event.IsChecked(); AppState::instance->saveState(); }, ID_CompilerCache);
+  Bind(wxEVT_MENU, [&](wxCommandEvent&) { if (BatchVerify::instance != nullptr) BatchVerify::instance->Raise(); else BatchVerify::instance = new BatchVerify(this); }, ID_BatchVerify);
+  Bind(wxEVT_MENU, [&](wxCommandEvent&) { SizeDashboard::show(this, activeEditor == nullptr ? std::string{} : activeEditor->getOpenConfig()); }, ID_SizeHistory);
+  Bind(wxEVT_MENU, [&](wxCommandEvent&) { if (FlashStation::instance != nullptr) FlashStation::instance->Raise(); else FlashStation::instance = new FlashStation(this); }, ID_FlashStation);
 
   Bind(wxEVT_COMBOBOX, [&](wxCommandEvent& event) { update(); event.Skip(); });
+  Bind(BoardWatch::EVT_CHANGED, [&](wxCommandEvent&) {
+        std::vector<BoardWatch::Port> ports;
+        if (BoardWatch::getPorts(ports)) setBoards(Arduino::getBoards(ports));
+      });
   Bind(wxEVT_BUTTON, [&](wxCommandEvent&) { Arduino::refreshBoards(this); }, ID_RefreshDev);
   Bind(wxEVT_BUTTON, [&](wxCommandEvent&) { Arduino::applyToBoard(this, activeEditor); }, ID_ApplyChanges);
 # if defined(__WXMSW__)
@@ -152,12 +173,30 @@ void MainMenu::createMenuBar() {
   file->Append(ID_Copyright, "Copyright Notice");
   file->Append(wxID_EXIT);
 
+  wxMenu* tools = new wxMenu;
+  tools->Append(ID_BatchVerify, "Batch Verify...", "Verify several configs for several boards at once");
+  tools->Append(ID_FlashStation, "Flashing Station...", "Flash many connected boards at once, each with its own config");
+  tools->Append(ID_SizeHistory, "Size History...", "See how flash and RAM usage changed over each config's builds");
+# ifdef __WXMSW__
+  tools->AppendCheckItem(ID_ConfigByProperty, "Leave ProffieOS.ino Unmodified", "Not available on Windows");
+  tools->Enable(ID_ConfigByProperty, false);
+# else
+  tools->AppendCheckItem(ID_ConfigByProperty, "Leave ProffieOS.ino Unmodified", "Select the config with a compiler flag instead of editing ProffieOS.ino (the version string is left as-is)");
+  tools->Check(ID_ConfigByProperty, AppState::instance->configByProperty);
+# endif
+  tools->AppendCheckItem(ID_SpeculativeBuild, "Build in Background on Save", "Compile configs shortly after they're saved, so applying them is quicker");
+  tools->Check(ID_SpeculativeBuild, AppState::instance->speculativeBuild);
+  tools->AppendCheckItem(ID_CompilerCache, "Use Compiler Cache", CompilerCache::isAvailable() ? "Reuse compiled ProffieOS code between builds with ccache" : "Requires ccache to be installed");
+  tools->Check(ID_CompilerCache, AppState::instance->compilerCache && CompilerCache::isAvailable());
+  tools->Enable(ID_CompilerCache, CompilerCache::isAvailable());
+
   wxMenu* help = new wxMenu;
   help->Append(ID_Docs, "Documentation...\tCtrl+H", "Open the ProffieConfig docs in your web browser");
   help->Append(ID_Issue, "Help/Bug Report...", "Open GitHub to submit issue");
 
   wxMenuBar *menuBar = new wxMenuBar;
   menuBar->Append(file, "&File");
+  menuBar->Append(tools, "&Tools");
   menuBar->Append(help, "&Help");
   SetMenuBar(menuBar);
 }
@@ -223,6 +262,16 @@ void MainMenu::createUI() {
   SetSizerAndFit(sizer);
 }
 
+void MainMenu::setBoards(const std::vector<wxString>& boards) {
+  auto lastBoard = boardSelect->entry()->GetStringSelection();
+  boardSelect->entry()->Clear();
+  for (const auto& board : boards) boardSelect->entry()->Append(board);
+
+  boardSelect->entry()->SetValue(lastBoard);
+  if (boardSelect->entry()->GetSelection() == -1) boardSelect->entry()->SetSelection(0);
+  update();
+}
+
 void MainMenu::update() {
   auto lastConfig = configSelect->entry()->GetValue();
   configSelect->entry()->Clear();
@@ -13,8 +13,11 @@ class MainMenu : public wxFrame {
 public:
   static MainMenu* instance;
   MainMenu(wxWindow* = nullptr);
+  ~MainMenu();
 
   void update();
+  // Replaces the board choices, keeping the selection if that board is still there
+  void setBoards(const std::vector<wxString>&);
 
   wxButton* refreshButton{nullptr};
   wxButton* applyButton{nullptr};
@@ -42,6 +45,12 @@ public:
     ID_Issue,
 
     ID_OpenSerial,
+    ID_BatchVerify,
+    ID_ConfigByProperty,
+    ID_SpeculativeBuild,
+    ID_CompilerCache,
+    ID_SizeHistory,
+    ID_FlashStation,
 
     ID_ConfigSelect,
     ID_AddConfig,
@@ -0,0 +1,17 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+
+// Each test is its own program; a failed CHECK is reported and counted, and main() returns the count.
+static int32_t failures{0};
+
+#define CHECK(condition) do { \
+    if (!(condition)) { \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " #condition << std::endl; \
+      failures++; \
+    } \
+  } while (0)
@@ -0,0 +1,101 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "core/config/definetable.h"
+#include "tests/check.h"
+
+#include <algorithm>
+#include <locale>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Generated config bytes mustn't depend on the order defines and prop settings come in, or on the locale.
+
+namespace {
+  struct Add {
+    std::string name;
+    std::string value;
+    DefineTable::Source source;
+  };
+
+  // A thousands separator and a decimal comma, as GTK can leave the global locale
+  struct CommaPunct : std::numpunct<char> {
+    char do_decimal_point() const override { return ','; }
+    char do_thousands_sep() const override { return '.'; }
+    std::string do_grouping() const override { return "\3"; }
+  };
+
+  // The CONFIG_TOP part of the model: general defines, then prop settings walked in SettingMap order, then custom ones
+  std::string generate(const std::vector<Add>& general, const std::vector<std::pair<std::string, std::string>>& propSettings, const std::vector<Add>& custom) {
+    DefineTable table;
+    for (const auto& add : general) table.add(add.name, add.value, add.source);
+    std::map<std::string, std::string> settingMap(propSettings.begin(), propSettings.end());
+    for (const auto& [ name, value ] : settingMap) table.add(name, value, DefineTable::Source::PROP);
+    for (const auto& add : custom) table.add(add.name + " " + add.value, add.source);
+
+    std::string output;
+    for (const auto& define : table.getOutput()) output += "#define " + define + "\n";
+    return output;
+  }
+}
+
+int main() {
+  std::locale::global(std::locale(std::locale::classic(), new CommaPunct));
+  std::ostringstream localized;
+  localized << 3.5;
+  CHECK(localized.str() == "3,5");
+  CHECK(DefineTable::formatDecimal(3.0) == "3.000000");
+  CHECK(DefineTable::formatDecimal(1234.5) == "1234.500000");
+
+  std::vector<Add> general{
+    { "NUM_BLADES", "2", DefineTable::Source::GENERAL },
+    { "NUM_BUTTONS", "2", DefineTable::Source::GENERAL },
+    { "VOLUME", "1500", DefineTable::Source::GENERAL },
+    { "CLASH_THRESHOLD_G", DefineTable::formatDecimal(3.0), DefineTable::Source::GENERAL },
+    { "SAVE_PRESET", "", DefineTable::Source::GENERAL },
+    { "SAVE_VOLUME", "", DefineTable::Source::GENERAL },
+    { "DISABLE_DIAGNOSTIC_COMMANDS", "", DefineTable::Source::GENERAL },
+    { "ORIENTATION", "ORIENTATION_FETS_TOWARDS_BLADE", DefineTable::Source::GENERAL },
+    { "PLI_OFF_TIME", "2 * 60 * 1000", DefineTable::Source::GENERAL },
+    { "IDLE_OFF_TIME", "15 * 60 * 1000", DefineTable::Source::GENERAL },
+  };
+  std::vector<std::pair<std::string, std::string>> propSettings{
+    { "FETT263_EDIT_MODE_MENU", "" },
+    { "FETT263_SWING_ON_SPEED", "250" },
+    { "FETT263_LOCKUP_DELAY", "200" },
+    { "DISABLE_BASIC_PARSER_STYLES", "" },
+    { "FETT263_TWIST_ON", "" },
+  };
+  std::vector<Add> custom{
+    { "ENABLE_AUDIO", "", DefineTable::Source::CUSTOM },
+    { "ENABLE_MOTION", "", DefineTable::Source::CUSTOM },
+    { "ENABLE_WS2811", "", DefineTable::Source::CUSTOM },
+    { "ENABLE_SD", "", DefineTable::Source::CUSTOM },
+    // Also set by general, written once whichever comes first
+    { "SAVE_PRESET", "", DefineTable::Source::CUSTOM },
+    { "BLADE_DETECT_PIN", "blade3Pin", DefineTable::Source::CUSTOM },
+  };
+
+  const auto expected = generate(general, propSettings, custom);
+  CHECK(expected.find("#define CLASH_THRESHOLD_G 3.000000\n") != std::string::npos);
+  CHECK(std::count(expected.begin(), expected.end(), '\n') == 20);
+
+  std::mt19937 random(28);
+  for (int32_t run = 0; run < 1000; run++) {
+    std::shuffle(general.begin(), general.end(), random);
+    std::shuffle(propSettings.begin(), propSettings.end(), random);
+    std::shuffle(custom.begin(), custom.end(), random);
+    // Sources added in any order too, not just shuffled within each
+    auto output = run % 2 ? generate(general, propSettings, custom) : generate(custom, propSettings, general);
+    if (output != expected) {
+      CHECK(output == expected);
+      std::cerr << "Run " << run << " differed:\n" << output << "instead of:\n" << expected;
+      break;
+    }
+  }
+
+  return failures;
+}
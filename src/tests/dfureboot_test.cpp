@@ -0,0 +1,76 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "tools/dfureboot.h"
+#include "tests/check.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// A pseudo-terminal plays the board, and a device node created in a temporary directory plays its bootloader.
+
+static std::string readLine(int32_t fd) {
+  std::string line;
+  char chr;
+  pollfd pollFd{ fd, POLLIN, 0 };
+  while (poll(&pollFd, 1, 2000) > 0 && read(fd, &chr, 1) == 1) {
+    line += chr;
+    if (chr == '\n') break;
+  }
+  return line;
+}
+
+int main() {
+  auto master = posix_openpt(O_RDWR | O_NOCTTY);
+  CHECK(master >= 0 && grantpt(master) == 0 && unlockpt(master) == 0);
+  std::string slave = ptsname(master);
+
+  char watchDir[] = "/tmp/dfureboot_testXXXXXX";
+  CHECK(mkdtemp(watchDir) != nullptr);
+  auto node = std::string(watchDir) + "/001";
+  auto present = [&node]() {
+    struct stat info;
+    return stat(node.c_str(), &info) == 0;
+  };
+
+  DFUReboot reboot({ watchDir });
+  std::string error;
+  CHECK(reboot.send(slave, error));
+  CHECK(error.empty());
+  CHECK(readLine(master) == "RebootDFU\r\n");
+
+  // Woken by the node appearing, not by running out of time
+  auto start = std::chrono::steady_clock::now();
+  std::thread bootloader([&node]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    close(open(node.c_str(), O_CREAT | O_WRONLY, 0600));
+  });
+  CHECK(reboot.wait(present, std::chrono::milliseconds(5000)));
+  bootloader.join();
+  auto waited = std::chrono::steady_clock::now() - start;
+  CHECK(waited >= std::chrono::milliseconds(300));
+  CHECK(waited < std::chrono::milliseconds(2000));
+
+  // Rounded up, never giving up short of the timeout
+  start = std::chrono::steady_clock::now();
+  CHECK(!reboot.wait([]() { return false; }, std::chrono::milliseconds(200)));
+  CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(200));
+
+  // Not a tty, so there's nothing to reboot
+  auto notTty = std::string(watchDir) + "/file";
+  close(open(notTty.c_str(), O_CREAT | O_WRONLY, 0600));
+  CHECK(!reboot.send(notTty, error));
+  CHECK(!error.empty());
+
+  unlink(notTty.c_str());
+  unlink(node.c_str());
+  rmdir(watchDir);
+  close(master);
+  return failures;
+}
@@ -0,0 +1,214 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "tools/presetsync.h"
+#include "core/defines.h"
+#include "tests/check.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#ifdef __APPLE__
+# include <util.h>
+#else
+# include <pty.h>
+#endif
+
+// A pseudo-terminal plays a ProffieOS board with SAVE_PRESET, answering the preset commands from
+// its own list and "Whut?" to anything else, in small pieces as a real serial port would.
+
+namespace {
+  std::vector<PresetSync::Preset> boardPresets{
+    { "zero", "font0", "tracks/a.wav", { "builtin 0 1", "builtin 0 2" } },
+    { "one\nline", "font1", "", { "builtin 1 1 ~ ~ 300", "builtin 1 2" } },
+  };
+  // As a ProffieOS built without SAVE_PRESET
+  std::atomic<bool> noSetFont{false};
+
+  std::string escape(const std::string& value) {
+    std::string result;
+    for (auto chr : value) {
+      if (chr == '\n') result += "\\n";
+      else if (chr == '\\') result += "\\\\";
+      else result += chr;
+    }
+    return result;
+  }
+
+  std::string answer(const std::string& line) {
+    auto space = line.find(' ');
+    auto command = line.substr(0, space);
+    auto args = space == std::string::npos ? "" : line.substr(space + 1);
+    char* valueStart;
+    auto index = std::strtoul(args.c_str(), &valueStart, 10);
+    while (*valueStart == ' ') valueStart++;
+    std::string value{valueStart};
+
+    if (command == "list_presets") {
+      std::string output;
+      for (const auto& preset : boardPresets) {
+        output += "FONT=" + escape(preset.font) + "\r\nTRACK=" + escape(preset.track) + "\r\n";
+        for (size_t blade = 0; blade < preset.styles.size(); blade++) {
+          output += "STYLE" + std::to_string(blade + 1) + "=" + escape(preset.styles[blade]) + "\r\n";
+        }
+        output += "NAME=" + escape(preset.name) + "\r\nVARIATION=0\r\n";
+      }
+      return output;
+    }
+    if (command == "set_font" && !noSetFont) boardPresets.at(index).font = value;
+    else if (command == "set_track") boardPresets.at(index).track = value;
+    else if (command == "set_name") boardPresets.at(index).name = value;
+    else if (command.rfind("set_style", 0) == 0) boardPresets.at(index).styles.at(std::atoi(command.c_str() + 9) - 1) = value;
+    else if (command == "duplicate_preset") boardPresets.insert(boardPresets.begin() + index + 1, boardPresets.at(index));
+    else if (command == "delete_preset") boardPresets.erase(boardPresets.begin() + index);
+    else return "Whut? :" + command + "\r\n";
+    return "";
+  }
+
+  void board(int32_t fd) {
+    std::string input;
+    char buffer[4096];
+    for (ssize_t count; (count = read(fd, buffer, sizeof(buffer))) > 0;) {
+      input.append(buffer, count);
+      for (auto end = input.find_first_of("\r\n"); end != std::string::npos; end = input.find_first_of("\r\n")) {
+        auto line = input.substr(0, end);
+        input.erase(0, end + 1);
+        if (line.empty()) continue;
+
+        auto output = answer(line);
+        for (size_t pos = 0; pos < output.size(); pos += 7) {
+          if (write(fd, output.data() + pos, std::min<size_t>(7, output.size() - pos)) < 0) return;
+        }
+      }
+    }
+  }
+
+  bool samePresets(const std::vector<PresetSync::Preset>& lhs, const std::vector<PresetSync::Preset>& rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.name == rhs.name && lhs.font == rhs.font && lhs.track == rhs.track && lhs.styles == rhs.styles;
+    });
+  }
+}
+
+int main() {
+  CHECK(PresetSync::getStyleArgs("StylePtr<Red>(\"~ ~ 300\")") == "~ ~ 300");
+  CHECK(PresetSync::getStyleArgs("StylePtr<Red>()").empty());
+  CHECK(PresetSync::setStyleArgs("StylePtr<Red>()", "1 2") == "StylePtr<Red>(\"1 2\")");
+  CHECK(PresetSync::setStyleArgs("StylePtr<Red>(\"1 2\")", "") == "StylePtr<Red>()");
+  CHECK(PresetSync::setStyleArgs("StylePtr<Red>(\"1 2\");", "3") == "StylePtr<Red>(\"3\");");
+  size_t preset, blade;
+  std::string args;
+  CHECK(PresetSync::parseBuiltin("builtin 1 2 ~ ~ 300", preset, blade, args) && preset == 1 && blade == 1 && args == "~ ~ 300");
+  CHECK(!PresetSync::parseBuiltin("standard 1 2", preset, blade, args));
+
+  int32_t master, slave;
+  termios raw{};
+  cfmakeraw(&raw);
+  CHECK(openpty(&master, &slave, nullptr, &raw, nullptr) == 0);
+  std::thread boardThread(board, master);
+
+  PresetSync sync([slave](const std::string& command) {
+    auto line = command + "\n";
+    CHECK(write(slave, line.data(), line.size()) == static_cast<ssize_t>(line.size()));
+  });
+  // What SerialMonitor does on its reader and timer
+  auto pump = [&](const std::function<bool()>& finished) {
+    auto start = std::chrono::steady_clock::now();
+    char buffer[4096];
+    while (!finished() && std::chrono::steady_clock::now() - start < std::chrono::seconds(10)) {
+      pollfd pollFd{ slave, POLLIN, 0 };
+      if (poll(&pollFd, 1, 100) > 0) {
+        auto count = read(slave, buffer, sizeof(buffer));
+        if (count > 0) sync.receive(std::string(buffer, count));
+      }
+      sync.checkTimeout();
+    }
+    CHECK(finished());
+  };
+  bool done{false};
+  auto isDone = [&done]() { return done; };
+
+  std::string error;
+  std::vector<PresetSync::Preset> listed;
+  auto list = [&]() {
+    done = false;
+    sync.list([&](const std::vector<PresetSync::Preset>& presets, const std::string& listError) {
+      listed = presets;
+      error = listError;
+      done = true;
+    });
+    pump(isDone);
+    CHECK(error.empty());
+  };
+  auto push = [&](const std::vector<PresetSync::Preset>& wanted) {
+    done = false;
+    sync.push(listed, wanted, [&](const std::string& pushError) {
+      error = pushError;
+      done = true;
+    });
+    pump(isDone);
+  };
+
+  list();
+  CHECK(listed.size() == 2);
+  CHECK(samePresets(listed, boardPresets));
+
+  // Changed, then grown from a copy of the last
+  auto wanted = listed;
+  wanted[0].font = "newfont;common";
+  wanted[1].styles[1] = "builtin 1 2 ~ 500";
+  wanted.push_back({ "third", "font2", "", { "builtin 2 1", "builtin 2 2" } });
+  wanted.push_back({ "fourth", "font3", "t.wav", { "builtin 3 1", "builtin 3 2 x" } });
+  push(wanted);
+  CHECK(error.empty());
+  list();
+  CHECK(samePresets(listed, wanted));
+  CHECK(PresetSync::diff(listed, wanted).empty());
+
+  wanted.resize(1);
+  push(wanted);
+  CHECK(error.empty());
+  list();
+  CHECK(samePresets(listed, wanted));
+
+  noSetFont = true;
+  wanted[0].font = "other";
+  push(wanted);
+  CHECK(error.find("\"set_font\"") != std::string::npos);
+  CHECK(!sync.busy());
+
+  // One at a time
+  sync.list([](const std::vector<PresetSync::Preset>&, const std::string&) {});
+  std::string busyError;
+  sync.list([&](const std::vector<PresetSync::Preset>&, const std::string& listError) { busyError = listError; });
+  CHECK(!busyError.empty());
+  pump([&sync]() { return !sync.busy(); });
+
+  // A board that never answers is given up on
+  PresetSync silent([](const std::string&) {});
+  done = false;
+  silent.list([&](const std::vector<PresetSync::Preset>&, const std::string& listError) {
+    error = listError;
+    done = true;
+  });
+  auto start = std::chrono::steady_clock::now();
+  while (!done && std::chrono::steady_clock::now() - start < std::chrono::milliseconds(PRESETSYNC_TIMEOUT * 2)) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    silent.checkTimeout();
+  }
+  CHECK(done);
+  CHECK(!error.empty());
+
+  close(slave);
+  boardThread.join();
+  close(master);
+  return failures;
+}
@@ -0,0 +1,142 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "tools/serialwriter.h"
+#include "core/utilities/notifier.h"
+#include "tests/check.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#ifdef __APPLE__
+# include <util.h>
+#else
+# include <pty.h>
+#endif
+
+// The writer on one end of a pseudo-terminal, as SerialMonitor runs it, and the board on the other.
+
+namespace {
+  // Up to `count` bytes, or fewer if nothing more arrives for a while
+  std::string readBoard(int32_t fd, size_t count) {
+    std::string data;
+    char buffer[4096];
+    pollfd pollFd{ fd, POLLIN, 0 };
+    while (data.size() < count && poll(&pollFd, 1, 2000) > 0) {
+      auto res = read(fd, buffer, std::min(sizeof(buffer), count - data.size()));
+      if (res <= 0) break;
+      data.append(buffer, res);
+    }
+    return data;
+  }
+
+  struct Port {
+    Port() {
+      termios raw{};
+      cfmakeraw(&raw);
+      CHECK(openpty(&board, &fd, nullptr, &raw, nullptr) == 0);
+      fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    }
+    ~Port() {
+      close(fd);
+      close(board);
+    }
+
+    int32_t board{-1};
+    // The end SerialMonitor would have open
+    int32_t fd{-1};
+  };
+}
+
+int main() {
+  // Queued in order, up to capacity
+  {
+    SerialWriter writer(4);
+    for (int32_t command = 0; command < 4; command++) CHECK(writer.send("command"));
+    CHECK(!writer.send("one too many"));
+  }
+
+  // Every command whole and in order, however many come at once
+  {
+    Port port;
+    Notifier stop;
+    SerialWriter writer(4096);
+    std::thread thread([&]() { writer.run(port.fd, stop.fd()); });
+
+    std::string expected;
+    for (int32_t command = 0; command < 2000; command++) {
+      auto text = "set_name " + std::to_string(command) + " " + std::string(command % 50, 'x');
+      expected += text + '\n';
+      CHECK(writer.send(text));
+    }
+    CHECK(readBoard(port.board, expected.size()) == expected);
+
+    stop.notify();
+    thread.join();
+  }
+
+  // Each command goes out as soon as it's sent, not on the next tick of a timer
+  {
+    Port port;
+    Notifier stop;
+    SerialWriter writer(4096);
+    std::thread thread([&]() { writer.run(port.fd, stop.fd()); });
+
+    std::vector<std::chrono::steady_clock::duration> latencies;
+    for (int32_t round = 0; round < 200; round++) {
+      auto start = std::chrono::steady_clock::now();
+      CHECK(writer.send("ping"));
+      CHECK(readBoard(port.board, 5) == "ping\n");
+      latencies.push_back(std::chrono::steady_clock::now() - start);
+    }
+    std::nth_element(latencies.begin(), latencies.begin() + latencies.size() / 2, latencies.end());
+    auto median = latencies[latencies.size() / 2];
+    std::cout << "Median send to receive: " << std::chrono::duration_cast<std::chrono::microseconds>(median).count() << "us" << std::endl;
+    CHECK(median < std::chrono::milliseconds(5));
+
+    stop.notify();
+    thread.join();
+  }
+
+  // Held off partway through a command by a board that isn't reading, and still stops when asked
+  {
+    Port port;
+    Notifier stop;
+    SerialWriter writer(4096);
+    std::thread thread([&]() { writer.run(port.fd, stop.fd()); });
+
+    std::string big(1024 * 1024, 'x');
+    CHECK(writer.send(big));
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    CHECK(!readBoard(port.board, 1).empty());
+
+    auto start = std::chrono::steady_clock::now();
+    stop.notify();
+    thread.join();
+    CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(500));
+  }
+
+  // And written whole once the board reads it all
+  {
+    Port port;
+    Notifier stop;
+    SerialWriter writer(4096);
+    std::thread thread([&]() { writer.run(port.fd, stop.fd()); });
+
+    std::string big(1024 * 1024, 'x');
+    CHECK(writer.send(big));
+    CHECK(writer.send("after"));
+    CHECK(readBoard(port.board, big.size() + 7) == big + "\nafter\n");
+
+    stop.notify();
+    thread.join();
+  }
+
+  return failures;
+}
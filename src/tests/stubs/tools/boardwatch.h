@@ -0,0 +1,20 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include <map>
+#include <string>
+
+// Stands in for the wx-based watcher: a pseudo-terminal never shows up in sysfs
+class BoardWatch {
+public:
+  struct Port {
+    std::string address{};
+    std::string protocol{};
+    bool proffieboard{false};
+    std::string serialNumber{};
+  };
+
+  static std::map<std::string, Port> scanSysfs() { return {}; }
+};
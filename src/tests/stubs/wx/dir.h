@@ -0,0 +1,22 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include <string>
+
+// Just enough for tools/dfureboot.cpp, finding no directories; tests always give it theirs
+#define wxEmptyString ""
+#define wxDIR_DIRS 0
+
+struct wxString : std::string {
+  using std::string::string;
+  std::string ToStdString() const { return *this; }
+};
+
+struct wxDir {
+  wxDir(const char*) {}
+  bool IsOpened() const { return false; }
+  bool GetFirst(wxString*, const char*, int) const { return false; }
+  bool GetNext(wxString*) const { return false; }
+};
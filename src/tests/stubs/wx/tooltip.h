@@ -0,0 +1,6 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+// core/defines.h only uses wxToolTip inside macros, which the tests never expand
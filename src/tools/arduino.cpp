@@ -4,14 +4,33 @@
 #include "arduino.h"
 
 #include "core/defines.h"
+#include "core/appstate.h"
+#include "core/config/buildsizes.h"
 #include "core/config/configuration.h"
+#include "core/config/costmodel.h"
 #include "core/utilities/misc.h"
 #include "core/utilities/progress.h"
 #include "core/utilities/threadrunner.h"
+#include "core/utilities/json.h"
+#include "tools/boardwatch.h"
+#include "tools/builddirs.h"
+#include "tools/compileprogress.h"
+#include "tools/compilercache.h"
+#include "tools/dfureboot.h"
+#include "tools/firmwarecache.h"
+#include "tools/sketchoverlay.h"
+#include "tools/speculativebuild.h"
+#include "tools/toolchain.h"
 #include "editor/editorwindow.h"
+#include "editor/dialogs/bladearraydlg.h"
+#include "editor/pages/bladespage.h"
 #include "editor/pages/generalpage.h"
 
+#include <algorithm>
+#include <cctype>
+#include <chrono>
 #include <cstring>
+#include <wx/filename.h>
 
 #ifdef __WXMSW__
 #include <windows.h>
@@ -24,14 +43,14 @@ void Arduino::init(wxWindow* parent, std::function<void(bool)> callback) {
   progDialog->SetTitle("Dependency Installation");
 
   new ThreadRunner([=]() {
-    FILE* install;
     std::string fulloutput;
-    char buffer[128];
-    
+
     progDialog->emitEvent(5, "Downloading dependencies...");
-    install = Arduino::CLI("core install proffieboard:stm32l4@" ARDUINO_PBPLUGIN_VERSION " --additional-urls https://profezzorn.github.io/arduino-proffieboard/package_proffieboard_index.json");
-    while (fgets(buffer, 128, install) != nullptr) { progDialog->emitEvent(-1, ""); fulloutput += buffer; }
-    if (pclose(install)) {
+    auto exitCode = Arduino::runCLI({ "core", "install", "proffieboard:stm32l4@" ARDUINO_PBPLUGIN_VERSION, "--additional-urls", "https://profezzorn.github.io/arduino-proffieboard/package_proffieboard_index.json" }, [&](const CLIEvent& event) {
+      progDialog->emitEvent(-1, "");
+      fulloutput += event.text + "\n";
+    });
+    if (exitCode != 0) {
       progDialog->emitEvent(100, "Error");
       std::cerr << fulloutput << std::endl;
       return callback(false);
@@ -39,7 +58,8 @@ void Arduino::init(wxWindow* parent, std::function<void(bool)> callback) {
 
 #   ifndef __WXOSX__
     progDialog->emitEvent(60, "Installing drivers...");
-    install = DRIVER_INSTALL;
+    char buffer[128];
+    FILE* install = DRIVER_INSTALL;
     while (fgets(buffer, 128, install) != nullptr) { progDialog->emitEvent(-1, ""); fulloutput += buffer; }
     if (pclose(install)) {
       progDialog->emitEvent(100, "Error");
@@ -59,42 +79,42 @@ void Arduino::refreshBoards(MainMenu* window, std::function<void(bool)> callback
   
   new ThreadRunner([=]() {
     progDialog->emitEvent(0, "Initializing...");
-    wxString lastSel = window->boardSelect->entry()->GetStringSelection();
-    window->boardSelect->entry()->Clear();
     progDialog->emitEvent(20, "Fetching Devices...");
-    for (const wxString& item : Arduino::getBoards()) {
-      window->boardSelect->entry()->Append(item);
-    }
-    
-    window->boardSelect->entry()->SetValue(lastSel);
-    if (window->boardSelect->entry()->GetSelection() == -1) window->boardSelect->entry()->SetSelection(0);
+    auto boards = Arduino::getBoards();
+    window->CallAfter([=]() { window->setBoards(boards); });
 
     progDialog->emitEvent(100, "Done.");
     return callback(true);
   });
 }
 std::vector<wxString> Arduino::getBoards() {
-  std::vector<wxString> boards{"Select Board..."};
-  char buffer[1024];
+  std::vector<BoardWatch::Port> ports;
+  if (BoardWatch::getPorts(ports)) return getBoards(ports);
 
-  FILE *arduinoCli = Arduino::CLI("board list");
+  BoardWatch::start();
 
-  if (!arduinoCli) {
-    return boards;
-  }
+  std::string output;
+  auto exitCode = runCLI({ "board", "list", "--format", "json" }, [&](const CLIEvent& event) {
+    if (event.stream == Process::Stream::STDOUT) output += event.text + "\n";
+  });
 
-  while (fgets(buffer, 1024, arduinoCli) != nullptr) {
-    if (std::strstr(buffer, "No boards found.") != nullptr) {
-      break;
-    }
+  JSON list;
+  if (exitCode != 0 || !JSON::parse(output, list)) {
+    std::cerr << "Failed to get board list: " << output << std::endl;
+  } else {
+    // Newer arduino-cli versions wrap the list in an object
+    const auto& entries = list.type == JSON::Type::OBJECT ? list["detected_ports"] : list;
+    for (const auto& entry : entries.array) ports.push_back(BoardWatch::parsePort(entry));
+  }
 
-    if ((std::strstr(buffer, "serial") != NULL && std::strstr(buffer, "proffieboard") != NULL)) {
-      *std::strpbrk(buffer, " ") = '\0'; // End string at break to get dev path
-      boards.push_back(buffer);
-    } else if (std::strstr(buffer, "dfu") != NULL) {
-      *std::strpbrk(buffer, " ") = '\0';
-      boards.push_back("BOOTLOADER|" + wxString(buffer));
-    }
+  return getBoards(ports);
+}
+std::vector<wxString> Arduino::getBoards(const std::vector<BoardWatch::Port>& ports) {
+  std::vector<wxString> boards{"Select Board..."};
+  for (const auto& port : ports) {
+    if (port.address.empty()) continue;
+    if (port.protocol == "dfu") boards.push_back("BOOTLOADER|" + wxString(port.address));
+    else if (port.protocol == "serial" && port.proffieboard) boards.push_back(port.address);
   }
 
 # ifdef __WXMSW__
@@ -109,23 +129,28 @@ void Arduino::applyToBoard(MainMenu* window, EditorWindow* editor, std::function
   
   new ThreadRunner([=]() {
     wxString returnVal;
+    auto phaseStart = std::chrono::steady_clock::now();
+    // Logs how long each step took, to see where an Apply spends its time
+    auto endPhase = [&](const char* phase) {
+      auto now = std::chrono::steady_clock::now();
+      std::cerr << "Apply: " << phase << " took " << std::chrono::duration_cast<std::chrono::milliseconds>(now - phaseStart).count() << "ms" << std::endl;
+      phaseStart = now;
+    };
 
     progDialog->emitEvent(0, "Initializing...");
 
     progDialog->emitEvent(10, "Checking board presence...");
     wxString lastSel = window->boardSelect->entry()->GetStringSelection();
-    window->boardSelect->entry()->Clear();
-    for (const wxString& item : Arduino::getBoards()) {
-      window->boardSelect->entry()->Append(item);
-    }
-    window->boardSelect->entry()->SetValue(lastSel);
-    if (window->boardSelect->entry()->GetSelection() == -1) {
-      window->boardSelect->entry()->SetSelection(0);
+    // Served from the BoardWatch when it's running, so this only scans when the list isn't being kept
+    auto boards = Arduino::getBoards();
+    window->CallAfter([=]() { window->setBoards(boards); });
+    if (std::find(boards.begin(), boards.end(), lastSel) == boards.end()) {
       progDialog->emitEvent(100, "Error!");
       Misc::MessageBoxEvent* msg = new Misc::MessageBoxEvent(wxID_ANY, "Please make sure your board is connected and selected, then try again!", "Board Selection Error", wxOK | wxICON_ERROR);
       wxQueueEvent(window->GetEventHandler(), msg);
       return callback(false);
     }
+    endPhase("checking board presence");
 
     progDialog->emitEvent(20, "Generating configuration file...");
     if (!Configuration::outputConfig(editor)) {
@@ -133,21 +158,36 @@ void Arduino::applyToBoard(MainMenu* window, EditorWindow* editor, std::function
       // NO message here because outputConfig will handle it.
       return callback(false);
     }
+    endPhase("generating configuration");
 
-    progDialog->emitEvent(30, "Updating ProffieOS file...");
-    if (!Arduino::updateIno(returnVal, editor)) {
-      progDialog->emitEvent(100, "Error");
-      Misc::MessageBoxEvent* msg = new Misc::MessageBoxEvent(wxID_ANY, "There was an error while updating ProffieOS file:\n\n" + returnVal, "Files Error");
-      wxQueueEvent(window->GetEventHandler(), msg);
-      return callback(false);
-    }
+    auto cacheKey = FirmwareCache::getKey(editor);
+    editor->speculativeBuild->settle(cacheKey, progDialog);
+#   ifdef __WXMSW__
+    // The Windows uploader is located from the compile output, so there's always a compile
+    std::string firmwareDir{};
+#   else
+    auto firmwareDir = FirmwareCache::find(cacheKey);
+#   endif
+    if (firmwareDir.empty()) {
+      progDialog->emitEvent(30, "Updating ProffieOS file...");
+      if (!Arduino::updateIno(returnVal, editor)) {
+        progDialog->emitEvent(100, "Error");
+        Misc::MessageBoxEvent* msg = new Misc::MessageBoxEvent(wxID_ANY, "There was an error while updating ProffieOS file:\n\n" + returnVal, "Files Error");
+        wxQueueEvent(window->GetEventHandler(), msg);
+        return callback(false);
+      }
 
-    progDialog->emitEvent(40, "Compiling ProffieOS...");
-    if (!Arduino::compile(returnVal, editor)) {
-      progDialog->emitEvent(100, "Error");
-      Misc::MessageBoxEvent* msg = new Misc::MessageBoxEvent(wxID_ANY, "There was an error while compiling:\n\n" + returnVal, "Compile Error");
-      wxQueueEvent(window->GetEventHandler(), msg);
-      return callback(false);
+      progDialog->emitEvent(40, "Compiling ProffieOS...");
+      if (!Arduino::compile(returnVal, editor, cacheKey, progDialog, 40, 64)) {
+        progDialog->emitEvent(100, "Error");
+        Misc::MessageBoxEvent* msg = new Misc::MessageBoxEvent(wxID_ANY, "There was an error while compiling:\n\n" + returnVal, "Compile Error");
+        wxQueueEvent(window->GetEventHandler(), msg);
+        return callback(false);
+      }
+      endPhase("compiling");
+    } else {
+      progDialog->emitEvent(40, "Using previously compiled firmware...");
+      endPhase("waiting for firmware");
     }
 
 #   ifdef __WXMSW__
@@ -176,6 +216,19 @@ void Arduino::applyToBoard(MainMenu* window, EditorWindow* editor, std::function
         Sleep(5000);
       }
     }
+#   elif defined(__linux__)
+    // Waits only as long as this board takes to come back in DFU, rather than whatever the upload tool allows for
+    if (!lastSel.StartsWith("BOOTLOADER") && !Toolchain::get()->isSimulated()) {
+      progDialog->emitEvent(50, "Rebooting Proffieboard...");
+      std::string error;
+      if (!DFUReboot::run(lastSel.ToStdString(), error)) {
+        progDialog->emitEvent(100, "Error");
+        Misc::MessageBoxEvent* msg = new Misc::MessageBoxEvent(wxID_ANY, "There was an error while rebooting the Proffieboard:\n\n" + error, "Upload Error");
+        wxQueueEvent(window->GetEventHandler(), msg);
+        return callback(false);
+      }
+      endPhase("rebooting to DFU");
+    }
 #   endif
 
     progDialog->emitEvent(65, "Uploading to ProffieBoard...");
@@ -200,13 +253,14 @@ void Arduino::applyToBoard(MainMenu* window, EditorWindow* editor, std::function
     }
 
 #   else
-    if (!Arduino::upload(returnVal, editor)) {
+    if (!Arduino::upload(returnVal, editor, firmwareDir)) {
       progDialog->emitEvent(100, "Error");
       Misc::MessageBoxEvent* msg = new Misc::MessageBoxEvent(wxID_ANY, "There was an error while uploading:\n\n" + returnVal, "Upload Error");
       wxQueueEvent(window->GetEventHandler(), msg);
       return callback(false);
     }
 #   endif
+    endPhase("uploading");
 
     progDialog->emitEvent(100, "Done.");
 
@@ -230,6 +284,15 @@ void Arduino::verifyConfig(wxWindow* parent, EditorWindow* editor, std::function
       return callback(false);
     }
 
+    auto cacheKey = FirmwareCache::getKey(editor);
+    editor->speculativeBuild->settle(cacheKey, progDialog);
+    if (!FirmwareCache::find(cacheKey).empty()) {
+      progDialog->emitEvent(100, "Done.");
+      Misc::MessageBoxEvent* msg = new Misc::MessageBoxEvent(wxID_ANY, "Config Verified Successfully!\n\n(This config was already compiled, no changes since.)", "Verify Config", wxOK | wxICON_INFORMATION);
+      wxQueueEvent(parent->GetEventHandler(), msg);
+      return callback(true);
+    }
+
     progDialog->emitEvent(30, "Updating ProffieOS file...");
     if (!Arduino::updateIno(returnVal, editor)) {
       progDialog->emitEvent(100, "Error");
@@ -240,7 +303,7 @@ void Arduino::verifyConfig(wxWindow* parent, EditorWindow* editor, std::function
     }
 
     progDialog->emitEvent(40, "Compiling ProffieOS...");
-    if (!Arduino::compile(returnVal, editor)) {
+    if (!Arduino::compile(returnVal, editor, cacheKey, progDialog, 40, 99)) {
       progDialog->emitEvent(100, "Error");
       Misc::MessageBoxEvent* msg = new Misc::MessageBoxEvent(wxID_ANY, "There was an error while compiling:\n\n"
                        + returnVal, "Compile Error");
@@ -249,102 +312,145 @@ void Arduino::verifyConfig(wxWindow* parent, EditorWindow* editor, std::function
     }
 
     progDialog->emitEvent(100, "Done.");
-    Misc::MessageBoxEvent* msg = new Misc::MessageBoxEvent(wxID_ANY, "Config Verified Successfully!", "Verify Config", wxOK | wxICON_INFORMATION);
+    wxString message = "Config Verified Successfully!";
+    auto sizes = BuildSizes::instance->describeLatest(editor->getOpenConfig(), CostModel::getBoard(editor));
+    if (!sizes.empty()) message += "\n\n" + sizes;
+    auto cacheReport = CompilerCache::findReport(returnVal.ToStdString());
+    if (!cacheReport.empty()) message += "\n" + cacheReport;
+    Misc::MessageBoxEvent* msg = new Misc::MessageBoxEvent(wxID_ANY, message, "Verify Config", wxOK | wxICON_INFORMATION);
     wxQueueEvent(parent->GetEventHandler(), msg);
 
     return callback(true);
   });
 }
 
-bool Arduino::compile(wxString& _return, EditorWindow* editor, Progress* progDialog) {
-  wxString output;
-  char buffer[1024];
-
-  wxString compileCommand = "compile ";
-  compileCommand += "-b ";
-  compileCommand += editor->generalPage->board->entry()->GetSelection() == PROFFIEBOARDV1 ? ARDUINOCORE_PBV1 : editor->generalPage->board->entry()->GetSelection() == PROFFIEBOARDV2 ? ARDUINOCORE_PBV2 : ARDUINOCORE_PBV3;
-  compileCommand += " --board-options ";
-  if (editor->generalPage->massStorage->GetValue() && editor->generalPage->webUSB->GetValue()) compileCommand += "usb=cdc_msc_webusb";
-  else if (editor->generalPage->webUSB->GetValue()) compileCommand += "usb=cdc_webusb";
-  else if (editor->generalPage->massStorage->GetValue()) compileCommand += "usb=cdc_msc";
-  else compileCommand += "usb=cdc";
-  if (editor->generalPage->board->entry()->GetSelection() == PROFFIEBOARDV3) compileCommand +=",dosfs=sdmmc1";
-  compileCommand += " " PROFFIEOS_PATH " -v";
-  FILE *arduinoCli = Arduino::CLI(compileCommand);
-
-  std::string error{};
+bool Arduino::compile(wxString& _return, EditorWindow* editor, const std::string& cacheKey, Progress* progDialog, int8_t progressStart, int8_t progressEnd) {
+  return compile(_return, getBuildTarget(editor), editor, cacheKey, progDialog, progressStart, progressEnd, nullptr);
+}
+bool Arduino::compile(wxString& _return, const BuildTarget& target, Toolchain::Cancellation* cancel) {
+  return compile(_return, target, nullptr, {}, nullptr, 0, 99, cancel);
+}
+bool Arduino::compile(wxString& _return, const BuildTarget& target, EditorWindow* editor, const std::string& cacheKey, Progress* progDialog, int8_t progressStart, int8_t progressEnd, Toolchain::Cancellation* cancel) {
+  const auto& fqbn = target.fqbn;
+  const auto& boardOptions = target.boardOptions;
+  auto buildDir = BuildDirs::acquire(target.config, fqbn, boardOptions);
+  BuildDirs::evict(buildDir);
+
+  CompileProgress progress(target.config, fqbn, boardOptions);
+  int8_t lastPercent{-1};
+  std::string lastMessage{};
+
+  std::string output{};
+  // The first error, and the last place in the config gcc said led to a diagnostic before it
+  CLIEvent firstError{};
+  CLIEvent configContext{};
+  CLIEvent errorContext{};
+# ifdef __WXMSW__
   std::wstring paths{};
-  while(fgets(buffer, sizeof(buffer), arduinoCli) != NULL) {
-    if (progDialog != nullptr) progDialog->emitEvent(-1, ""); // Pulse
-    error += buffer;
-    if (std::strstr(buffer, "error")) {
-      _return = Arduino::parseError(error);
+# endif
+  std::vector<std::string> args{ "compile", "-b", fqbn, "--board-options", boardOptions, "--build-path", buildDir.build, buildDir.sketch, "-v" };
+  if (target.configSelect == SketchOverlay::ConfigSelect::BUILD_PROPERTY) {
+    auto properties = Toolchain::get()->getBuildProperties(fqbn, boardOptions, buildDir.sketch);
+    if (properties.empty()) {
+      _return = "Could not read the board's build properties.";
       return false;
     }
+    args.insert(args.end(), { "--build-property", SketchOverlay::getConfigProperty(target.config + ".h", properties["compiler.cpp.extra_flags"]) });
+  }
+  auto cacheArgs = CompilerCache::getBuildArgs(fqbn, boardOptions, buildDir.sketch);
+  args.insert(args.end(), cacheArgs.begin(), cacheArgs.end());
+  auto cacheBefore = cacheArgs.empty() ? CompilerCache::Stats{} : CompilerCache::getStats();
+  auto exitCode = runCLI(args, [&](const CLIEvent& event) {
+    output += event.text + "\n";
+    if (event.type == CLIEvent::Type::DIAGNOSTIC && firstError.type != CLIEvent::Type::DIAGNOSTIC) {
+      if (event.severity == "required") {
+        if (isConfigFile(event.file, target.config)) configContext = event;
+      } else if (event.severity == "error" || event.severity == "fatal error") {
+        firstError = event;
+        errorContext = configContext;
+      } else if (event.severity != "note") configContext = {};
+    }
+    if (progress.update(event) && progDialog != nullptr) {
+      auto percent = static_cast<int8_t>(progressStart + progress.getFraction() * (progressEnd - progressStart));
+      auto message = progress.describe();
+      if (percent != lastPercent || message != lastMessage) progDialog->emitEvent(percent, message);
+      lastPercent = percent;
+      lastMessage = message;
+    }
 #   ifdef __WXMSW__
-    if (std::strstr(buffer, "ProffieOS.ino.dfu") && std::strstr(buffer, "stm32l4") && std::strstr(buffer, "C:\\")) {
-      std::cerr << "ErrBufferFull: " << error << std::endl;
-      error = buffer;
-      std::cerr << "PathBuffer: " << error << std::endl;
+    const auto& line = event.text;
+    if (paths.empty() && line.find("ProffieOS.ino.dfu") != std::string::npos && line.find("stm32l4") != std::string::npos && line.find("C:\\") != std::string::npos) {
+      std::cerr << "PathBuffer: " << line << std::endl;
 
       // Ugly code because Windows wants wchar_t*, which requires (ish) std::wstring's
       wchar_t shortPath[MAX_PATH];
-      GetShortPathName(std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>>().from_bytes(error.substr(error.rfind("C:\\"), error.rfind("ProffieOS.ino.dfu") - error.rfind("C:\\") + 17)).c_str(), shortPath, MAX_PATH);
+      GetShortPathName(std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>>().from_bytes(line.substr(line.rfind("C:\\"), line.rfind("ProffieOS.ino.dfu") - line.rfind("C:\\") + 17)).c_str(), shortPath, MAX_PATH);
       paths = shortPath;
       paths += L"|";
-      GetShortPathName(std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>>().from_bytes(error.substr(1, error.find("windows") + 7 - 1)).c_str(), shortPath, MAX_PATH);
+      GetShortPathName(std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>>().from_bytes(line.substr(1, line.find("windows") + 7 - 1)).c_str(), shortPath, MAX_PATH);
       paths += shortPath;
       paths += LR"(\\stm32l4-upload.bat)";
       std::cerr << "ParsedPaths: " << paths << std::endl;
-
-      pclose(arduinoCli);
-      _return = paths;
-      return true;
     }
 #   endif
-  }
-  if (pclose(arduinoCli) != 0) {
-    _return = "Unknown Compile Error";
+  }, cancel, editor == nullptr);
+  // The exit code decides, not the output; "error" shows up in plenty of harmless places (file names, -Werror=...)
+  if (exitCode != 0) {
+    if (exitCode < 0) _return = "Could not run arduino-cli.";
+    else if (editor == nullptr || !locateError(_return, editor, firstError, errorContext)) _return = Arduino::parseError(output);
     return false;
   }
 
+  progress.finish();
+
+  if (!cacheArgs.empty()) {
+    auto report = CompilerCache::describe(cacheBefore, CompilerCache::getStats());
+    if (!report.empty()) {
+      std::cerr << report << std::endl;
+      output += report + "\n";
+    }
+  }
+
+  CostModel::Sample sizes;
+  if (CostModel::parseSizes(output, sizes)) {
+    sizes.board = target.board;
+    sizes.features = target.features;
+    CostModel::instance->record(sizes);
+    // Batch editors have internal names, BatchVerify records those under the real config
+    if (target.config.rfind('.', 0) != 0) BuildSizes::instance->record(target.config, sizes.board, sizes.flash, sizes.ram);
+  }
 
-  _return = error;
 # ifdef __WXMSW__
-  return false;
+  if (paths.empty()) {
+    _return = output;
+    return false;
+  }
+  FirmwareCache::store(cacheKey, buildDir.build);
+  _return = paths;
+  return true;
 # else
+  FirmwareCache::store(cacheKey, buildDir.build);
+  _return = output;
   return true;
 #endif
 }
-bool Arduino::upload(wxString& _return, EditorWindow* editor, Progress* progDialog) {
-  char buffer[1024];
-
-  wxString uploadCommand = "upload ";
-  uploadCommand += PROFFIEOS_PATH;
-  uploadCommand += " --board-options ";
-  if (editor->generalPage->massStorage->GetValue() && editor->generalPage->webUSB->GetValue()) uploadCommand += "usb=cdc_msc_webusb";
-  else if (editor->generalPage->webUSB->GetValue()) uploadCommand += "usb=cdc_webusb";
-  else if (editor->generalPage->massStorage->GetValue()) uploadCommand += "usb=cdc_msc";
-  else uploadCommand += "usb=cdc";
-  if (editor->generalPage->board->entry()->GetStringSelection() == "ProffieBoard V3") uploadCommand +=",dosfs=sdmmc1";
-
-  uploadCommand += " --fqbn ";
-  uploadCommand += editor->generalPage->board->entry()->GetSelection() == 0 ? ARDUINOCORE_PBV1 : editor->generalPage->board->entry()->GetSelection() == 1 ? ARDUINOCORE_PBV2 : ARDUINOCORE_PBV3;
-  uploadCommand += " -v";
-
-  FILE *arduinoCli = Arduino::CLI(uploadCommand);
-
-  wxString error{};
-  while(fgets(buffer, sizeof(buffer), arduinoCli) != NULL) {
+bool Arduino::upload(wxString& _return, EditorWindow* editor, const std::string& inputDir, Progress* progDialog, const BoardWatch::Port& port) {
+  auto fqbn = getFQBN(editor);
+  auto boardOptions = getBoardOptions(editor);
+  // Upload what compile just built rather than looking in arduino-cli's default build location
+  auto firmwareDir = inputDir.empty() ? BuildDirs::acquire(editor->getOpenConfig(), fqbn, boardOptions).build : inputDir;
+
+  std::vector<std::string> args{ "upload", PROFFIEOS_PATH, "--board-options", boardOptions, "--fqbn", fqbn, "--input-dir", firmwareDir, "-v" };
+  // Otherwise the core picks whichever board it finds
+  if (!port.address.empty()) args.insert(args.end(), { "-p", port.address, "-l", port.protocol });
+
+  std::string output{};
+  auto exitCode = runCLI(args, [&](const CLIEvent& event) {
     if (progDialog != nullptr) progDialog->emitEvent(-1, ""); // Pulse
-    error += buffer;
-    if (std::strstr(buffer, "error")) {
-      _return = Arduino::parseError(error);
-      return false;
-    }
-  }
-  if (pclose(arduinoCli) != 0) {
-    _return = "Unknown Upload Error";
+    output += event.text + "\n";
+  });
+  if (exitCode != 0) {
+    _return = exitCode < 0 ? wxString("Could not run arduino-cli.") : Arduino::parseError(output);
     return false;
   }
 
@@ -352,39 +458,97 @@ bool Arduino::upload(wxString& _return, EditorWindow* editor, Progress* progDial
   return true;
 }
 bool Arduino::updateIno(wxString& _return, EditorWindow* _editor) {
-  std::ifstream input(PROFFIEOS_INO);
-  if (!input.is_open()) {
-    _return = "ERROR OPENING FOR READ";
+  BuildTarget target;
+  target.config = _editor->getOpenConfig();
+  target.fqbn = getFQBN(_editor);
+  target.boardOptions = getBoardOptions(_editor);
+  target.configSelect = getConfigSelect();
+  return updateIno(_return, target);
+}
+bool Arduino::updateIno(wxString& _return, const BuildTarget& target) {
+  auto buildDir = BuildDirs::acquire(target.config, target.fqbn, target.boardOptions);
+  std::string overlayError;
+  if (!SketchOverlay::create(buildDir.sketch, target.config + ".h", target.configSelect, overlayError)) {
+    _return = overlayError;
     return false;
   }
 
-  std::string fileData;
-  std::vector<wxString> outputData;
-  while(!input.eof()) {
-    getline(input, fileData);
-    if (fileData.find(R"(// #define CONFIG_FILE "config/YOUR_CONFIG_FILE_NAME_HERE.h")") != std::string::npos) outputData.push_back("#define CONFIG_FILE \"config/" + _editor->getOpenConfig() + ".h\"");
-    if (fileData.find(R"(#define CONFIG_FILE)") == 0) outputData.push_back("#define CONFIG_FILE \"config/" + _editor->getOpenConfig() + ".h\"");
-    else if (fileData.find(R"(const char version[] = ")" ) != std::string::npos) outputData.push_back(R"(const char version[] = ")" PROFFIEOS_VERSION R"(";)");
-    else outputData.push_back(fileData);
-  }
-  input.close();
+  _return.clear();
+  return true;
+}
+
+bool Arduino::isConfigFile(const std::string& file, const std::string& config) {
+  auto name = config + ".h";
+  if (file.size() < name.size() + 7 || file.compare(file.size() - name.size(), name.size(), name) != 0) return false;
+  auto dir = file.substr(file.size() - name.size() - 7, 7);
+  return dir == "config/" || dir == "config\\";
+}
 
+bool Arduino::locateError(wxString& _return, EditorWindow* editor, const CLIEvent& error, const CLIEvent& context) {
+  if (error.type != CLIEvent::Type::DIAGNOSTIC) return false;
 
-  std::ofstream output(PROFFIEOS_INO);
-  if (!output.is_open()) {
-    _return = "ERROR OPENING FOR WRITE";
-    return false;
-  }
+  const auto& position = isConfigFile(error.file, editor->getOpenConfig()) ? error : context;
+  if (position.type != CLIEvent::Type::DIAGNOSTIC) return false;
 
-  for (const wxString& line : outputData) {
-    output << line << std::endl;
+  SourceMap::Location location;
+  if (!editor->sourceMap.resolve(position.line, position.column, location)) {
+    _return = wxString::Format("Error on line %d of the config:\n\n", position.line) + error.message;
+    return true;
   }
-  output.close();
 
-  _return.clear();
+  const auto& bladeArrays = editor->bladesPage->bladeArrayDlg->bladeArrays;
+  if (location.bladeArray >= static_cast<int32_t>(bladeArrays.size()) || location.preset >= static_cast<int32_t>(bladeArrays[location.bladeArray].presets.size())) return false;
+  const auto& preset = bladeArrays[location.bladeArray].presets[location.preset];
+  _return = "Error in the style for blade " + std::to_string(location.blade) + " of preset \"" + preset.name + "\" (blade array \"" + bladeArrays[location.bladeArray].name + "\"), ";
+  _return += wxString::Format("style line %d, column %d:\n\n", location.styleLine + 1, location.styleColumn + 1) + error.message;
+
+  // Hidden editors belong to batch runs, nobody's looking at those
+  editor->CallAfter([editor, location]() {
+    if (editor->IsShown()) editor->jumpToStyle(location);
+  });
   return true;
 }
 
+SketchOverlay::ConfigSelect Arduino::getConfigSelect() {
+# ifdef __WXMSW__
+  // Process::start can't pass the property's quotes through cmd.exe intact
+  return SketchOverlay::ConfigSelect::PATCH_INO;
+# else
+  return AppState::instance->configByProperty ? SketchOverlay::ConfigSelect::BUILD_PROPERTY : SketchOverlay::ConfigSelect::PATCH_INO;
+# endif
+}
+
+Arduino::BuildTarget Arduino::getBuildTarget(EditorWindow* editor) {
+  BuildTarget target;
+  target.config = editor->getOpenConfig();
+  target.fqbn = getFQBN(editor);
+  target.boardOptions = getBoardOptions(editor);
+  target.configSelect = getConfigSelect();
+  target.board = CostModel::getBoard(editor);
+  target.features = CostModel::getFeatures(editor);
+  return target;
+}
+
+std::string Arduino::getFQBN(EditorWindow* editor) {
+  switch (editor->generalPage->board->entry()->GetSelection()) {
+    case PROFFIEBOARDV1:
+      return ARDUINOCORE_PBV1;
+    case PROFFIEBOARDV2:
+      return ARDUINOCORE_PBV2;
+    default:
+      return ARDUINOCORE_PBV3;
+  }
+}
+std::string Arduino::getBoardOptions(EditorWindow* editor) {
+  std::string options;
+  if (editor->generalPage->massStorage->GetValue() && editor->generalPage->webUSB->GetValue()) options += "usb=cdc_msc_webusb";
+  else if (editor->generalPage->webUSB->GetValue()) options += "usb=cdc_webusb";
+  else if (editor->generalPage->massStorage->GetValue()) options += "usb=cdc_msc";
+  else options += "usb=cdc";
+  if (editor->generalPage->board->entry()->GetSelection() == PROFFIEBOARDV3) options += ",dosfs=sdmmc1";
+  return options;
+}
+
 wxString Arduino::parseError(const wxString& error) {
   std::cerr << "An arduino task failed with the following error: " << std::endl;
   std::cerr << error << std::endl;
@@ -403,15 +567,70 @@ wxString Arduino::parseError(const wxString& error) {
 #undef ERRCONTAINS
 }
 
-FILE* Arduino::CLI(const wxString& command) {
-  wxString fullCommand;
-# if defined(__WXMSW__)
-  fullCommand += "title ProffieConfig Worker & ";
-  fullCommand += R"(resources\windowmode -title "ProffieConfig Worker" -mode force_minimized & )";
-# endif
-  fullCommand += ARDUINO_PATH " ";
-  fullCommand += command;
-  fullCommand += " 2>&1";
+int32_t Arduino::runCLI(const std::vector<std::string>& args, const std::function<void(const CLIEvent&)>& handler, Toolchain::Cancellation* cancel, bool lowPriority) {
+  return Toolchain::get()->run(args, [&](const Process::Line& line) { handler(parseCLILine(line)); }, cancel, lowPriority);
+}
+
+Arduino::CLIEvent Arduino::parseCLILine(const Process::Line& line) {
+  CLIEvent event;
+  event.stream = line.stream;
+  event.text = line.text;
+
+  // GCC: "path/file.cpp:12:5: error: message", column and "fatal " optional
+  // Template instantiation context: "path/file.h:40:7:   required from here"
+  // Split by hand, style errors can run to tens of KB and std::regex recurses once per character.
+  const std::string& text{line.text};
+  size_t pos{0};
+  // A number and the ':' after it, moving past both
+  auto readNumber = [&](int32_t& number) {
+    auto start = pos;
+    number = 0;
+    while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos])) && pos - start < 9) number = number * 10 + (text[pos++] - '0');
+    return pos != start && pos < text.size() && text[pos++] == ':';
+  };
+  auto diagnostic = [&](size_t fileEnd, int32_t lineNum, int32_t column, const std::string& severity, size_t messageStart) {
+    event.type = CLIEvent::Type::DIAGNOSTIC;
+    event.file = text.substr(0, fileEnd);
+    event.line = lineNum;
+    event.column = column;
+    event.severity = severity;
+    event.message = text.substr(messageStart);
+  };
+
+  // The file ends at the first ":<digits>:", which a drive letter's colon isn't
+  int32_t lineNum{0};
+  auto fileEnd = text.find(':');
+  for (; fileEnd != std::string::npos; fileEnd = text.find(':', fileEnd + 1)) {
+    pos = fileEnd + 1;
+    if (fileEnd > 0 && readNumber(lineNum)) break;
+  }
+
+  if (fileEnd != std::string::npos) {
+    auto afterLine = pos;
+    int32_t column{0};
+    auto hasColumn = readNumber(column);
+    if (!hasColumn) {
+      pos = afterLine;
+      column = 0;
+    }
+
+    for (std::string severity : { "fatal error", "error", "warning", "note" }) {
+      auto prefix = " " + severity + ": ";
+      if (text.compare(pos, prefix.size(), prefix) != 0) continue;
+      diagnostic(fileEnd, lineNum, column, severity, pos + prefix.size());
+      return event;
+    }
+
+    auto context = text.find_first_not_of(" \t", pos);
+    if (hasColumn && context != pos && context != std::string::npos && text.compare(context, 14, "required from ") == 0) {
+      diagnostic(fileEnd, lineNum, column, "required", context + 14);
+      return event;
+    }
+  }
+
+  if (line.text.rfind("Sketch uses ", 0) == 0 || line.text.rfind("Global variables use ", 0) == 0) {
+    event.type = CLIEvent::Type::SIZE;
+  }
 
-  return popen(fullCommand.data(), "r");
+  return event;
 }
@@ -8,6 +8,10 @@
 #include "editor/editorwindow.h"
 #include "mainmenu/mainmenu.h"
 #include "core/utilities/progress.h"
+#include "tools/boardwatch.h"
+#include "tools/process.h"
+#include "tools/sketchoverlay.h"
+#include "tools/toolchain.h"
 
 class Arduino {
 public:
@@ -16,7 +20,44 @@ public:
   static void verifyConfig(wxWindow*, EditorWindow*, std::function<void(bool)> = [](bool){});
 
   static void init(wxWindow*, std::function<void(bool)> = [](bool){});
+  // Combo box entries for the connected boards
   static std::vector<wxString> getBoards();
+  static std::vector<wxString> getBoards(const std::vector<BoardWatch::Port>&);
+
+  static std::string getFQBN(EditorWindow*);
+  static std::string getBoardOptions(EditorWindow*);
+  static SketchOverlay::ConfigSelect getConfigSelect();
+
+  // Everything a build reads from the editor, taken on the UI thread so a build on another can't see it change midway
+  struct BuildTarget {
+    std::string config{};
+    std::string fqbn{};
+    std::string boardOptions{};
+    SketchOverlay::ConfigSelect configSelect{SketchOverlay::ConfigSelect::PATCH_INO};
+    // What the CostModel records the build's sizes under
+    std::string board{};
+    std::vector<std::string> features{};
+  };
+  static BuildTarget getBuildTarget(EditorWindow*);
+
+  // One line of arduino-cli output, with what could be recognized of it
+  struct CLIEvent {
+    enum class Type {
+      OUTPUT,
+      DIAGNOSTIC,
+      SIZE,
+    } type{Type::OUTPUT};
+    Process::Stream stream{Process::Stream::STDOUT};
+    std::string text{};
+
+    // DIAGNOSTIC only
+    std::string file{};
+    int32_t line{0};
+    int32_t column{0};
+    // As gcc prints it, or "required" for a "required from" instantiation context line
+    std::string severity{};
+    std::string message{};
+  };
 
   enum {
     PROFFIEBOARDV1 = 0,
@@ -24,13 +65,35 @@ public:
     PROFFIEBOARDV3 = 2
   };
 private:
+  friend class BatchVerify;
+  friend class FlashStation;
+  friend class SpeculativeBuild;
+
   Arduino();
   Arduino(const Arduino&) = delete;
 
-  static FILE* CLI(const wxString& command);
+  // Runs arduino-cli (through the Toolchain) with args, handing each line of output to handler as it arrives.
+  // Returns the exit code, -1 if it couldn't run or was cancelled.
+  static int32_t runCLI(const std::vector<std::string>& args, const std::function<void(const CLIEvent&)>& handler, Toolchain::Cancellation* = nullptr, bool lowPriority = false);
+  static CLIEvent parseCLILine(const Process::Line&);
 
+  // Sets up the config's sketch overlay, pointed at the config the way getConfigSelect() says
   static bool updateIno(wxString&, EditorWindow*);
-  static bool compile(wxString&, EditorWindow*, Progress* = nullptr);
-  static bool upload(wxString&, EditorWindow*, Progress* = nullptr);
+  static bool updateIno(wxString&, const BuildTarget&);
+  // Successful builds are added to the FirmwareCache under cacheKey, if one is given.
+  // Progress is reported to the dialog between progressStart and progressEnd.
+  static bool compile(wxString&, EditorWindow*, const std::string& cacheKey = {}, Progress* = nullptr, int8_t progressStart = 0, int8_t progressEnd = 99);
+  // In the background: at low priority, cancellable, and reading nothing but `target`.
+  // Errors aren't traced back into the presets, there's nobody to show them to.
+  static bool compile(wxString&, const BuildTarget&, Toolchain::Cancellation*);
+  // Both of the above, `editor` is null in the background
+  static bool compile(wxString&, const BuildTarget&, EditorWindow*, const std::string& cacheKey, Progress*, int8_t progressStart, int8_t progressEnd, Toolchain::Cancellation*);
+  // Uploads the firmware in inputDir, or from the config's build directory if empty, to port if given
+  static bool upload(wxString&, EditorWindow*, const std::string& inputDir = {}, Progress* = nullptr, const BoardWatch::Port& port = {});
   static wxString parseError(const wxString&);
+  // Whether a diagnostic's file is the config, wherever the sketch it was compiled in lives
+  static bool isConfigFile(const std::string& file, const std::string& config);
+  // Describes error by where it is in the presets, using context when the error itself is outside the config,
+  // and takes the editor there. False if neither points into the config.
+  static bool locateError(wxString&, EditorWindow*, const CLIEvent& error, const CLIEvent& context);
 };
@@ -0,0 +1,288 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "tools/batchverify.h"
+
+#include "core/defines.h"
+#include "core/appstate.h"
+#include "core/config/buildsizes.h"
+#include "core/config/configuration.h"
+#include "core/config/costmodel.h"
+#include "core/utilities/threadrunner.h"
+#include "editor/editorwindow.h"
+#include "editor/pages/generalpage.h"
+#include "tools/arduino.h"
+#include "tools/firmwarecache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#ifdef __WXMSW__
+#undef wxMessageDialog
+#include <wx/msgdlg.h>
+#define wxMessageDialog wxGenericMessageDialog
+#else
+#include <wx/msgdlg.h>
+#endif
+#include <wx/sizer.h>
+#include <wx/statbox.h>
+#include <wx/thread.h>
+#include <wx/utils.h>
+
+// Rough peak for one arduino-cli + gcc compiling ProffieOS
+#define COMPILE_MEMORY (512 * 1024 * 1024)
+
+BatchVerify* BatchVerify::instance{nullptr};
+wxEventTypeTag<wxCommandEvent> BatchVerify::EVT_JOBUPDATE(wxNewEventType());
+
+BatchVerify::BatchVerify(MainMenu* _parent) : wxFrame(_parent, wxID_ANY, "Batch Verify"), parent(_parent) {
+  instance = this;
+
+  createUI();
+  bindEvents();
+
+# ifdef __WXMSW__
+  SetIcon( wxICON(IDI_ICON1) );
+  SetBackgroundColour(wxSystemSettings::GetColour(wxSYS_COLOUR_FRAMEBK));
+# endif
+  Show(true);
+}
+BatchVerify::~BatchVerify() {
+  instance = nullptr;
+}
+
+void BatchVerify::createUI() {
+  auto sizer = new wxBoxSizer(wxVERTICAL);
+
+  auto selection = new wxBoxSizer(wxHORIZONTAL);
+  auto configs = new wxStaticBoxSizer(wxVERTICAL, this, "Configs");
+  wxArrayString configNames;
+  for (const auto& config : AppState::instance->getConfigFileNames()) configNames.Add(config);
+  configList = new wxCheckListBox(configs->GetStaticBox(), wxID_ANY, wxDefaultPosition, wxSize(200, 150), configNames);
+  for (uint32_t idx = 0; idx < configList->GetCount(); idx++) configList->Check(idx);
+  configs->Add(configList, wxSizerFlags(1).Border(wxALL, 5).Expand());
+
+  auto boards = new wxStaticBoxSizer(wxVERTICAL, this, "Boards");
+  for (const auto& [ name, include ] : Configuration::Proffieboard) {
+    auto boardCheck = new wxCheckBox(boards->GetStaticBox(), wxID_ANY, name);
+    // V1s are rare enough that they're opt-in
+    boardCheck->SetValue(static_cast<int32_t>(boardChecks.size()) != Arduino::PROFFIEBOARDV1);
+    boards->Add(boardCheck, FIRSTITEMFLAGS);
+    boardChecks.push_back(boardCheck);
+  }
+
+  selection->Add(configs, wxSizerFlags(1).Border(wxALL, 5).Expand());
+  selection->Add(boards, wxSizerFlags(0).Border(wxALL, 5).Expand());
+
+  auto controls = new wxBoxSizer(wxHORIZONTAL);
+  startButton = new wxButton(this, ID_Start, "Verify Selected");
+  status = new wxStaticText(this, wxID_ANY, "");
+  rebuildCheck = new wxCheckBox(this, wxID_ANY, "Rebuild Compiled Configs");
+  rebuildCheck->SetToolTip("Compile even configs that were already compiled, to time full builds");
+  controls->Add(startButton, wxSizerFlags(0).Border(wxALL, 5));
+  controls->Add(rebuildCheck, wxSizerFlags(0).Border(wxALL, 5).Center());
+  controls->Add(status, wxSizerFlags(1).Border(wxALL, 5).Center());
+
+  results = new wxListCtrl(this, wxID_ANY, wxDefaultPosition, wxSize(600, 250), wxLC_REPORT | wxLC_SINGLE_SEL);
+  results->AppendColumn("Config", wxLIST_FORMAT_LEFT, 150);
+  results->AppendColumn("Board", wxLIST_FORMAT_LEFT, 120);
+  results->AppendColumn("Result", wxLIST_FORMAT_LEFT, 150);
+  results->AppendColumn("Flash", wxLIST_FORMAT_RIGHT, 100);
+  results->AppendColumn("Time", wxLIST_FORMAT_RIGHT, 70);
+
+  sizer->Add(selection, wxSizerFlags(0).Expand());
+  sizer->Add(controls, wxSizerFlags(0).Border(wxLEFT | wxRIGHT, 5).Expand());
+  sizer->Add(results, wxSizerFlags(1).Border(wxALL, 10).Expand());
+
+  SetSizerAndFit(sizer);
+}
+
+void BatchVerify::bindEvents() {
+  Bind(wxEVT_CLOSE_WINDOW, [&](wxCloseEvent& event) {
+    if (running && event.CanVeto()) {
+      wxMessageDialog(this, "Please wait for the running jobs to finish.", "Batch Verify Running", wxOK | wxICON_INFORMATION).ShowModal();
+      event.Veto();
+      return;
+    }
+    event.Skip();
+  });
+  Bind(wxEVT_BUTTON, [&](wxCommandEvent&) { start(); }, ID_Start);
+  Bind(EVT_JOBUPDATE, [&](wxCommandEvent& event) {
+    if (event.GetInt() < 0) finish();
+    else updateRow(event.GetInt());
+  }, wxID_ANY);
+}
+
+void BatchVerify::start() {
+  wxArrayInt selectedConfigs;
+  configList->GetCheckedItems(selectedConfigs);
+
+  jobs.clear();
+  nextJob = 0;
+  results->DeleteAllItems();
+  for (const auto configIdx : selectedConfigs) {
+    auto config = configList->GetString(configIdx).ToStdString();
+    for (int32_t board = 0; board < static_cast<int32_t>(boardChecks.size()); board++) {
+      if (!boardChecks[board]->GetValue()) continue;
+
+      // Separate name so the user's saved config is never overwritten with another board's
+      auto editor = new EditorWindow(".batch-" + config + "-" + std::to_string(board + 1), this);
+      Job job{ config, board, editor };
+      if (!Configuration::readConfig(CONFIG_DIR + config + ".h", editor)) {
+        job.result.state = Result::State::FAILED;
+        job.result.message = "Could not read config";
+      }
+      editor->generalPage->board->entry()->SetSelection(board);
+      jobs.push_back(job);
+
+      auto row = results->InsertItem(results->GetItemCount(), config);
+      results->SetItem(row, 1, boardChecks[board]->GetLabel());
+      updateRow(jobs.size() - 1);
+    }
+  }
+  if (jobs.empty()) {
+    wxMessageDialog(this, "Select at least one config and one board.", "Nothing To Verify", wxOK | wxICON_INFORMATION).ShowModal();
+    return;
+  }
+
+  startButton->Disable();
+  rebuildCheck->Disable();
+  configList->Disable();
+  for (auto boardCheck : boardChecks) boardCheck->Disable();
+
+  auto workers = std::min<int32_t>(getWorkerCount(), jobs.size());
+  status->SetLabel(wxString::Format("Running %d jobs, %d at a time...", static_cast<int32_t>(jobs.size()), workers));
+  running = true;
+  rebuild = rebuildCheck->GetValue();
+  startTime = std::chrono::steady_clock::now();
+  cacheBefore = CompilerCache::getStats();
+  runningWorkers = workers;
+  for (int32_t worker = 0; worker < workers; worker++) new ThreadRunner([this]() { runJobs(); });
+}
+
+void BatchVerify::finish() {
+  int32_t passed{0};
+  for (auto& job : jobs) {
+    if (job.result.state == Result::State::PASSED) passed++;
+    job.editor->Destroy();
+    job.editor = nullptr;
+  }
+
+  running = false;
+  auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+  wxString summary = wxString::Format("%d of %d passed in %.0fs.", passed, static_cast<int32_t>(jobs.size()), seconds);
+  auto cacheReport = CompilerCache::describe(cacheBefore, CompilerCache::getStats());
+  if (!cacheReport.empty()) summary += " " + cacheReport;
+  status->SetLabel(summary);
+  std::cerr << "Batch verify" << (rebuild ? " (rebuild)" : "") << ": " << summary << std::endl;
+  startButton->Enable();
+  rebuildCheck->Enable();
+  configList->Enable();
+  for (auto boardCheck : boardChecks) boardCheck->Enable();
+}
+
+void BatchVerify::runJobs() {
+  while (true) {
+    size_t jobIdx;
+    std::string config;
+    EditorWindow* editor;
+    {
+      std::lock_guard<std::mutex> guard(jobLock);
+      while (nextJob < jobs.size() && jobs[nextJob].result.state != Result::State::QUEUED) nextJob++;
+      if (nextJob >= jobs.size()) break;
+      jobIdx = nextJob++;
+      jobs[jobIdx].result.state = Result::State::RUNNING;
+      config = jobs[jobIdx].config;
+      editor = jobs[jobIdx].editor;
+    }
+    postUpdate(jobIdx);
+
+    auto result = runJob(config, editor, rebuild);
+    {
+      std::lock_guard<std::mutex> guard(jobLock);
+      jobs[jobIdx].result = result;
+    }
+    postUpdate(jobIdx);
+  }
+
+  if (--runningWorkers == 0) postUpdate(-1);
+}
+
+BatchVerify::Result BatchVerify::runJob(const std::string& config, EditorWindow* editor, bool rebuild) {
+  auto startTime = std::chrono::steady_clock::now();
+  Result result;
+  result.state = Result::State::FAILED;
+
+  wxString returnVal;
+  if (!Configuration::outputConfig(editor)) {
+    result.message = "Config error";
+  } else {
+    auto cacheKey = FirmwareCache::getKey(editor);
+    if (!rebuild && !FirmwareCache::find(cacheKey).empty()) {
+      result.state = Result::State::PASSED;
+      result.cached = true;
+    } else {
+      if (!Arduino::updateIno(returnVal, editor)) {
+        result.message = "Could not update ProffieOS file: " + returnVal.ToStdString();
+      } else if (!Arduino::compile(returnVal, editor, cacheKey)) {
+        result.message = returnVal.ToStdString();
+      } else {
+        result.state = Result::State::PASSED;
+        CostModel::Sample sizes;
+        if (CostModel::parseSizes(returnVal.ToStdString(), sizes)) {
+          result.flashUsed = sizes.flash.used;
+          result.flashMax = sizes.flash.max;
+          BuildSizes::instance->record(config, CostModel::getBoard(editor), sizes.flash, sizes.ram);
+        }
+      }
+    }
+  }
+  remove((CONFIG_DIR + editor->getOpenConfig() + ".h").c_str());
+
+  result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+  return result;
+}
+
+void BatchVerify::postUpdate(int32_t job) {
+  auto event = new wxCommandEvent(EVT_JOBUPDATE, wxID_ANY);
+  event->SetInt(job);
+  wxQueueEvent(GetEventHandler(), event);
+}
+
+void BatchVerify::updateRow(size_t jobIdx) {
+  Result result;
+  {
+    std::lock_guard<std::mutex> guard(jobLock);
+    result = jobs[jobIdx].result;
+  }
+
+  wxString state;
+  switch (result.state) {
+    case Result::State::QUEUED:
+      state = "Queued";
+      break;
+    case Result::State::RUNNING:
+      state = "Running...";
+      break;
+    case Result::State::PASSED:
+      state = result.cached ? "Passed (cached)" : "Passed";
+      break;
+    case Result::State::FAILED:
+      state = "Failed: " + result.message;
+      state.Replace("\n", " ");
+      break;
+  }
+  results->SetItem(jobIdx, 2, state);
+  results->SetItem(jobIdx, 3, result.flashMax ? wxString::Format("%.1f%%", result.flashUsed * 100.0 / result.flashMax) : wxString("-"));
+  results->SetItem(jobIdx, 4, result.state == Result::State::PASSED || result.state == Result::State::FAILED ? wxString::Format("%.1fs", result.seconds) : wxString(""));
+  if (result.state == Result::State::FAILED) results->SetItemTextColour(jobIdx, *wxRED);
+}
+
+int32_t BatchVerify::getWorkerCount() {
+  int32_t workers = std::max(1, wxThread::GetCPUCount());
+  auto freeMemory = wxGetFreeMemory();
+  // -1 if the platform can't tell us
+  if (freeMemory > 0) workers = std::min<int32_t>(workers, std::max<long>(1, (freeMemory / COMPILE_MEMORY).ToLong()));
+  return workers;
+}
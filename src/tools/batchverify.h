@@ -0,0 +1,91 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include "mainmenu/mainmenu.h"
+
+#include "tools/compilercache.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <wx/button.h>
+#include <wx/checkbox.h>
+#include <wx/checklst.h>
+#include <wx/frame.h>
+#include <wx/listctrl.h>
+#include <wx/stattext.h>
+
+// Verifies a set of configs against a set of boards, running as many jobs at once as the machine can take.
+class BatchVerify : public wxFrame {
+public:
+  BatchVerify(MainMenu*);
+  ~BatchVerify();
+  static BatchVerify* instance;
+
+private:
+  struct Result {
+    enum class State {
+      QUEUED,
+      RUNNING,
+      PASSED,
+      FAILED
+    } state{State::QUEUED};
+    bool cached{false};
+    std::string message{};
+    uint32_t flashUsed{0};
+    uint32_t flashMax{0};
+    double seconds{0};
+  };
+  struct Job {
+    std::string config;
+    int32_t board;
+    // Hidden, with the config loaded and the board switched, so the config can be regenerated for this board
+    EditorWindow* editor{nullptr};
+    Result result{};
+  };
+
+  static wxEventTypeTag<wxCommandEvent> EVT_JOBUPDATE;
+
+  enum {
+    ID_Start,
+  };
+
+  MainMenu* parent{nullptr};
+
+  wxCheckListBox* configList{nullptr};
+  std::vector<wxCheckBox*> boardChecks{};
+  wxButton* startButton{nullptr};
+  wxCheckBox* rebuildCheck{nullptr};
+  wxStaticText* status{nullptr};
+  wxListCtrl* results{nullptr};
+
+  std::mutex jobLock{};
+  std::vector<Job> jobs{};
+  size_t nextJob{0};
+  std::atomic<int32_t> runningWorkers{0};
+  // Only cleared once the last worker's final event has been handled, so the window outlives every worker
+  bool running{false};
+  // For the summary, so cold and warm runs over the same configs can be compared
+  bool rebuild{false};
+  std::chrono::steady_clock::time_point startTime{};
+  CompilerCache::Stats cacheBefore{};
+
+  void createUI();
+  void bindEvents();
+
+  void start();
+  void finish();
+  void runJobs();
+  // rebuild ignores the FirmwareCache, for timing full builds
+  static Result runJob(const std::string& config, EditorWindow*, bool rebuild);
+  void postUpdate(int32_t job);
+  void updateRow(size_t job);
+
+  static int32_t getWorkerCount();
+};
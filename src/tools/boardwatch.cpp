@@ -0,0 +1,271 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "tools/boardwatch.h"
+
+#include "core/defines.h"
+#include "core/utilities/json.h"
+#include "core/utilities/threadrunner.h"
+#include "tools/toolchain.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <wx/dir.h>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+// arduino-cli reports every port already present as an "add" event once discovery has run;
+// until then an empty list can't be told apart from a list that isn't filled in yet.
+#define DISCOVERY_SETTLE std::chrono::seconds(2)
+
+// Proffieboard running ProffieOS, and the STM32 ROM bootloader it reboots into for DFU
+#define PROFFIEBOARD_VID "1209"
+#define PROFFIEBOARD_PID "6668"
+#define STM32DFU_VID "0483"
+#define STM32DFU_PID "df11"
+
+wxEventTypeTag<wxCommandEvent> BoardWatch::EVT_CHANGED(wxNewEventType());
+
+std::mutex BoardWatch::lock{};
+Toolchain::Cancellation* BoardWatch::cancel{nullptr};
+bool BoardWatch::running{false};
+std::chrono::steady_clock::time_point BoardWatch::started{};
+std::map<std::string, BoardWatch::Port> BoardWatch::ports{};
+std::vector<wxEvtHandler*> BoardWatch::listeners{};
+#ifdef __linux__
+int32_t BoardWatch::ueventFd{-1};
+int32_t BoardWatch::stopFd{-1};
+#endif
+
+void BoardWatch::start() {
+# ifdef __WXMSW__
+  // Windows processes go through the shell and can't be stopped, so the watch would outlive ProffieConfig.
+  return;
+# else
+  std::lock_guard<std::mutex> guard(lock);
+  if (running) return;
+
+# ifdef __linux__
+  // A stand-in toolchain gets to say which boards there are
+  if (!Toolchain::get()->isSimulated() && startUevents()) return;
+# endif
+
+  cancel = new Toolchain::Cancellation();
+  running = true;
+  started = std::chrono::steady_clock::now();
+  ports.clear();
+
+  new ThreadRunner(&BoardWatch::run);
+# endif
+}
+
+void BoardWatch::stop() {
+  std::lock_guard<std::mutex> guard(lock);
+  if (cancel != nullptr) cancel->cancel();
+# ifdef __linux__
+  if (stopFd != -1) {
+    uint64_t wake{1};
+    write(stopFd, &wake, sizeof(wake));
+  }
+# endif
+}
+
+void BoardWatch::addListener(wxEvtHandler* listener) {
+  std::lock_guard<std::mutex> guard(lock);
+  listeners.push_back(listener);
+}
+void BoardWatch::removeListener(wxEvtHandler* listener) {
+  std::lock_guard<std::mutex> guard(lock);
+  listeners.erase(std::remove(listeners.begin(), listeners.end(), listener), listeners.end());
+}
+void BoardWatch::notify() {
+  for (auto listener : listeners) wxQueueEvent(listener, new wxCommandEvent(EVT_CHANGED, wxID_ANY));
+}
+
+bool BoardWatch::getPorts(std::vector<Port>& out) {
+  std::lock_guard<std::mutex> guard(lock);
+  // Only arduino-cli needs time to settle, sysfs is read in full up front
+  if (!running || (cancel != nullptr && std::chrono::steady_clock::now() - started < DISCOVERY_SETTLE)) return false;
+
+  out.clear();
+  for (const auto& [ address, port ] : ports) out.push_back(port);
+  return true;
+}
+
+BoardWatch::Port BoardWatch::parsePort(const JSON& entry) {
+  // `board list` and newer watch output nest the port, older watch output flattens it into the event
+  const auto& port = entry["port"].type == JSON::Type::OBJECT ? entry["port"] : entry;
+  const auto& boards = entry["matching_boards"].type == JSON::Type::ARRAY ? entry["matching_boards"] : entry["boards"];
+
+  Port result;
+  result.address = port["address"].str();
+  result.protocol = port["protocol"].str();
+  result.serialNumber = port["properties"]["serialNumber"].str();
+  for (const auto& board : boards.array) {
+    if (board["fqbn"].str().rfind("proffieboard:", 0) != 0) continue;
+    result.proffieboard = true;
+    break;
+  }
+  return result;
+}
+
+void BoardWatch::run() {
+  // Events are pretty-printed over several lines, so collect until the braces balance
+  std::string object{};
+  int32_t depth{0};
+  bool inString{false}, escaped{false};
+
+  auto exitCode = Toolchain::get()->run({ "board", "list", "--watch", "--format", "json" }, [&](const Process::Line& line) {
+    if (line.stream != Process::Stream::STDOUT) return;
+
+    for (const char chr : line.text) {
+      if (depth > 0) object += chr;
+      if (inString) {
+        if (escaped) escaped = false;
+        else if (chr == '\\') escaped = true;
+        else if (chr == '"') inString = false;
+        continue;
+      }
+
+      if (chr == '"') inString = true;
+      else if (chr == '{') {
+        if (depth++ == 0) object = "{";
+      } else if (chr == '}' && depth > 0 && --depth == 0) {
+        JSON event;
+        if (JSON::parse(object, event)) handleEvent(event);
+        object.clear();
+      }
+    }
+    if (depth > 0) object += '\n';
+  }, cancel);
+  std::cerr << "Board watch exited (" << exitCode << "), falling back to one-shot board lists." << std::endl;
+
+  std::lock_guard<std::mutex> guard(lock);
+  delete cancel;
+  cancel = nullptr;
+  running = false;
+  ports.clear();
+}
+
+void BoardWatch::handleEvent(const JSON& event) {
+  const auto& type = event["eventType"].type == JSON::Type::STRING ? event["eventType"].str() : event["type"].str();
+  auto port = parsePort(event);
+  if (port.address.empty()) return;
+
+  std::lock_guard<std::mutex> guard(lock);
+  if (type == "add") ports[port.address] = port;
+  else if (type == "remove") ports.erase(port.address);
+  else return;
+  notify();
+}
+
+#ifdef __linux__
+
+bool BoardWatch::startUevents() {
+  ueventFd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+  if (ueventFd < 0) return false;
+
+  sockaddr_nl address{};
+  address.nl_family = AF_NETLINK;
+  address.nl_groups = 1; // Kernel events, rather than udev's rebroadcast
+  stopFd = eventfd(0, EFD_CLOEXEC);
+  if (bind(ueventFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || stopFd < 0) {
+    std::cerr << "Could not listen for device events, using arduino-cli to watch for boards." << std::endl;
+    close(ueventFd);
+    if (stopFd >= 0) close(stopFd);
+    ueventFd = stopFd = -1;
+    return false;
+  }
+
+  // Scanned after subscribing, so nothing plugged in between the two is missed
+  ports = scanSysfs();
+  running = true;
+  new ThreadRunner(&BoardWatch::runUevents);
+  return true;
+}
+
+void BoardWatch::runUevents() {
+  char buffer[8192];
+  while (true) {
+    pollfd fds[2]{ { ueventFd, POLLIN, 0 }, { stopFd, POLLIN, 0 } };
+    if (poll(fds, 2, -1) < 0) {
+      if (errno == EINTR) continue;
+      break;
+    }
+    if (fds[1].revents || (fds[0].revents & POLLIN) == 0) break;
+
+    auto size = recv(ueventFd, buffer, sizeof(buffer) - 1, MSG_DONTWAIT);
+    // ENOBUFS means events were dropped, so rescan without knowing what changed
+    if (size < 0 && errno != ENOBUFS) continue;
+
+    // "action@devpath\0KEY=VALUE\0...", only USB and tty events can change the list
+    bool relevant{size < 0};
+    if (size > 0) buffer[size] = '\0';
+    for (ssize_t field = 0; field < size; field += std::strlen(buffer + field) + 1) {
+      const std::string text = buffer + field;
+      if (text == "SUBSYSTEM=usb" || text == "SUBSYSTEM=tty") relevant = true;
+    }
+    if (!relevant) continue;
+
+    auto found = scanSysfs();
+    std::lock_guard<std::mutex> guard(lock);
+    auto changed = found.size() != ports.size() || !std::equal(found.begin(), found.end(), ports.begin(), [](const auto& lhs, const auto& rhs) {
+      return lhs.first == rhs.first && lhs.second.protocol == rhs.second.protocol;
+    });
+    if (!changed) continue;
+    ports = found;
+    notify();
+  }
+
+  std::lock_guard<std::mutex> guard(lock);
+  close(ueventFd);
+  close(stopFd);
+  ueventFd = stopFd = -1;
+  running = false;
+  ports.clear();
+}
+
+std::map<std::string, BoardWatch::Port> BoardWatch::scanSysfs() {
+  auto readAttribute = [](const wxString& path) {
+    std::ifstream file(path.ToStdString());
+    std::string value;
+    std::getline(file, value);
+    return value;
+  };
+
+  std::map<std::string, Port> found;
+  wxString name;
+
+  // A tty's device is the USB interface, whose parent is the USB device with the IDs
+  wxDir ttys("/sys/class/tty");
+  for (bool more = ttys.IsOpened() && ttys.GetFirst(&name, "ttyACM*"); more; more = ttys.GetNext(&name)) {
+    wxString device = "/sys/class/tty/" + name + "/device/../";
+    if (readAttribute(device + "idVendor") != PROFFIEBOARD_VID || readAttribute(device + "idProduct") != PROFFIEBOARD_PID) continue;
+
+    auto address = "/dev/" + name.ToStdString();
+    found[address] = { address, "serial", true, readAttribute(device + "serial") };
+  }
+
+  // The bootloader has no tty, only the USB device itself
+  wxDir usbDevices("/sys/bus/usb/devices");
+  for (bool more = usbDevices.IsOpened() && usbDevices.GetFirst(&name); more; more = usbDevices.GetNext(&name)) {
+    wxString device = "/sys/bus/usb/devices/" + name + "/";
+    if (readAttribute(device + "idVendor") != STM32DFU_VID || readAttribute(device + "idProduct") != STM32DFU_PID) continue;
+
+    auto address = name.ToStdString();
+    found[address] = { address, "dfu", false, readAttribute(device + "serial") };
+  }
+
+  return found;
+}
+
+#endif
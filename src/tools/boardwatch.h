@@ -0,0 +1,78 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include "tools/toolchain.h"
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <wx/event.h>
+
+class JSON;
+
+// Keeps the list of connected Proffieboards current for the whole session, so it's
+// already known when it's asked for instead of scanning for boards every time.
+// On Linux this follows the kernel's device events and reads VID/PID from sysfs,
+// elsewhere it keeps one `arduino-cli board list --watch` running.
+class BoardWatch {
+public:
+  struct Port {
+    std::string address{};
+    std::string protocol{};
+    bool proffieboard{false};
+    // Empty if the port doesn't report one
+    std::string serialNumber{};
+  };
+
+  // Queued to every listener whenever the port list changes
+  static wxEventTypeTag<wxCommandEvent> EVT_CHANGED;
+
+  // Both are safe to call repeatedly; start() does nothing if the watch is already running.
+  static void start();
+  static void stop();
+
+  static void addListener(wxEvtHandler*);
+  static void removeListener(wxEvtHandler*);
+
+  // False if the watch isn't running or hasn't finished its first discovery pass,
+  // in which case the caller should do a one-shot `board list` instead.
+  static bool getPorts(std::vector<Port>&);
+
+  // Reads a port entry from `board list` or `board list --watch` output; the layout differs between arduino-cli versions.
+  static Port parsePort(const JSON&);
+
+# ifdef __linux__
+  // Connected Proffieboards and bootloaders straight from sysfs, whether or not the watch is running
+  static std::map<std::string, Port> scanSysfs();
+# endif
+
+private:
+  BoardWatch();
+  BoardWatch(const BoardWatch&) = delete;
+
+  static void run();
+  static void handleEvent(const JSON&);
+  // Lock must be held
+  static void notify();
+
+  static std::mutex lock;
+  // Set while the watch runs through arduino-cli
+  static Toolchain::Cancellation* cancel;
+  static bool running;
+  static std::chrono::steady_clock::time_point started;
+  static std::map<std::string, Port> ports;
+  static std::vector<wxEvtHandler*> listeners;
+
+# ifdef __linux__
+  static int32_t ueventFd;
+  static int32_t stopFd;
+
+  // Lock must be held
+  static bool startUevents();
+  static void runUevents();
+# endif
+};
@@ -0,0 +1,96 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "tools/builddirs.h"
+
+#include "core/defines.h"
+#include "core/utilities/hash.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <vector>
+
+#include <wx/datetime.h>
+#include <wx/dir.h>
+#include <wx/filename.h>
+
+// A ProffieOS build directory is on the order of 50MB, so this keeps a couple dozen around.
+#define BUILDDIRS_MAXSIZE (1536ull * 1024 * 1024)
+// Touched on every use, since directory mtimes only change when entries are added or removed.
+#define BUILDDIR_MARKER ".lastused"
+
+std::mutex BuildDirs::lock;
+
+BuildDirs::Entry BuildDirs::acquire(const std::string& config, const std::string& fqbn, const std::string& boardOptions) {
+  std::lock_guard<std::mutex> guard(lock);
+
+  // Config name first so the directory is recognizable, hash so every combination gets its own
+  std::string name;
+  for (const char chr : config) name += std::isalnum(static_cast<unsigned char>(chr)) ? chr : '_';
+  name += "-" + Hash().add(config).add('\0').add(fqbn).add('\0').add(boardOptions).hex();
+
+  wxFileName buildDir = wxFileName::DirName(BUILDDIRS_PATH);
+  buildDir.AppendDir(name);
+  buildDir.MakeAbsolute();
+  if (!buildDir.DirExists() && !buildDir.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL)) {
+    std::cerr << "Failed to create build directory " << buildDir.GetPath() << std::endl;
+  }
+
+  wxFileName marker(buildDir.GetPath(), BUILDDIR_MARKER);
+  if (!marker.Touch()) std::cerr << "Failed to mark build directory as used." << std::endl;
+
+  Entry entry;
+  entry.root = buildDir.GetPath().ToStdString();
+  buildDir.AppendDir("build");
+  entry.build = buildDir.GetPath().ToStdString();
+  buildDir.RemoveLastDir();
+  // arduino-cli wants the sketch directory named after its .ino
+  buildDir.AppendDir("ProffieOS");
+  entry.sketch = buildDir.GetPath().ToStdString();
+  return entry;
+}
+
+void BuildDirs::evict(const Entry& keep) {
+  std::lock_guard<std::mutex> guard(lock);
+
+  wxDir buildsDir(BUILDDIRS_PATH);
+  if (!buildsDir.IsOpened()) return;
+
+  struct Entry {
+    wxString path;
+    wxDateTime lastUsed;
+    wxULongLong size;
+  };
+  std::vector<Entry> entries;
+  wxULongLong totalSize{0};
+
+  wxString name;
+  for (bool found = buildsDir.GetFirst(&name, wxEmptyString, wxDIR_DIRS | wxDIR_HIDDEN); found; found = buildsDir.GetNext(&name)) {
+    wxFileName buildDir = wxFileName::DirName(BUILDDIRS_PATH);
+    buildDir.AppendDir(name);
+    buildDir.MakeAbsolute();
+
+    Entry entry{ buildDir.GetPath(), {}, wxDir::GetTotalSize(buildDir.GetPath()) };
+    if (entry.size == wxInvalidSize) continue;
+    wxFileName marker(entry.path, BUILDDIR_MARKER);
+    // Directories without a marker were interrupted before their first use finished; they go first.
+    entry.lastUsed = marker.FileExists() ? marker.GetModificationTime() : wxDateTime((time_t)0);
+
+    totalSize += entry.size;
+    entries.push_back(entry);
+  }
+
+  std::sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) { return lhs.lastUsed < rhs.lastUsed; });
+  for (const auto& entry : entries) {
+    if (totalSize <= BUILDDIRS_MAXSIZE) break;
+    if (entry.path == keep.root) continue;
+
+    std::cerr << "Evicting build directory " << entry.path << "..." << std::endl;
+    if (!wxFileName::Rmdir(entry.path, wxPATH_RMDIR_RECURSIVE)) {
+      std::cerr << "Failed to remove build directory " << entry.path << std::endl;
+      continue;
+    }
+    totalSize -= entry.size;
+  }
+}
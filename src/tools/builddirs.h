@@ -0,0 +1,30 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include <mutex>
+#include <string>
+
+// Persistent arduino-cli build directories, one per (config, board, board options), so switching
+// between configs or boards doesn't throw away the incremental state of the others.
+// Each also holds the sketch overlay that gets built into it (see SketchOverlay).
+class BuildDirs {
+public:
+  struct Entry {
+    std::string root;
+    std::string build;
+    std::string sketch;
+  };
+
+  // Absolute paths for this combination, created if needed and marked most recently used.
+  static Entry acquire(const std::string& config, const std::string& fqbn, const std::string& boardOptions);
+  // Deletes least recently used entries until the total is under BUILDDIRS_MAXSIZE, never touching `keep`.
+  static void evict(const Entry& keep);
+
+private:
+  BuildDirs();
+  BuildDirs(const BuildDirs&) = delete;
+
+  static std::mutex lock;
+};
@@ -0,0 +1,156 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "tools/capturesearch.h"
+
+#include "core/defines.h"
+#include "core/utilities/threadrunner.h"
+#include "tools/serialcapture.h"
+
+#include <algorithm>
+#include <limits>
+#include <wx/sizer.h>
+
+// Lines shown from one search
+#define SEARCH_LIMIT 100000
+
+CaptureSearch* CaptureSearch::instance{nullptr};
+
+void CaptureSearch::show(MainMenu* parent, const std::string& session) {
+  if (instance == nullptr) instance = new CaptureSearch(parent);
+  instance->updateSessions(session);
+  instance->Show(true);
+  instance->Raise();
+}
+
+CaptureSearch::CaptureSearch(MainMenu* parent) : wxFrame(parent, wxID_ANY, "Search Serial Captures") {
+  createUI();
+  bindEvents();
+
+# ifdef __WXMSW__
+  SetIcon( wxICON(IDI_ICON1) );
+  SetBackgroundColour(wxSystemSettings::GetColour(wxSYS_COLOUR_FRAMEBK));
+# endif
+}
+CaptureSearch::~CaptureSearch() {
+  instance = nullptr;
+}
+
+void CaptureSearch::createUI() {
+  auto sizer = new wxBoxSizer(wxVERTICAL);
+
+  sessionSelect = new wxChoice(this, ID_Session);
+
+  auto range = new wxBoxSizer(wxHORIZONTAL);
+  from = new wxTextCtrl(this, wxID_ANY, wxEmptyString, wxDefaultPosition, wxSize(190, -1));
+  to = new wxTextCtrl(this, wxID_ANY, wxEmptyString, wxDefaultPosition, wxSize(190, -1));
+  range->Add(new wxStaticText(this, wxID_ANY, "From"), wxSizerFlags(0).Center().Border(wxRIGHT, 5));
+  range->Add(from, wxSizerFlags(0).Border(wxRIGHT, 10));
+  range->Add(new wxStaticText(this, wxID_ANY, "To"), wxSizerFlags(0).Center().Border(wxRIGHT, 5));
+  range->Add(to, wxSizerFlags(0));
+
+  auto query = new wxBoxSizer(wxHORIZONTAL);
+  pattern = new wxTextCtrl(this, ID_Search, wxEmptyString, wxDefaultPosition, wxDefaultSize, wxTE_PROCESS_ENTER);
+  pattern->SetHint("Regular expression (blank for every line)");
+  searchButton = new wxButton(this, ID_Search, "Search");
+  query->Add(pattern, wxSizerFlags(1).Border(wxRIGHT, 5));
+  query->Add(searchButton, wxSizerFlags(0));
+
+  status = new wxStaticText(this, wxID_ANY, wxEmptyString);
+  results = new LogView(this, SEARCH_LIMIT);
+  results->SetMinSize(wxSize(640, 300));
+
+  sizer->Add(sessionSelect, wxSizerFlags(0).Border(wxLEFT | wxRIGHT | wxTOP, 10).Expand());
+  sizer->Add(range, wxSizerFlags(0).Border(wxLEFT | wxRIGHT | wxTOP, 10));
+  sizer->Add(query, wxSizerFlags(0).Border(wxLEFT | wxRIGHT | wxTOP, 10).Expand());
+  sizer->Add(status, wxSizerFlags(0).Border(wxLEFT | wxRIGHT | wxTOP, 10));
+  sizer->Add(results, wxSizerFlags(1).Border(wxALL, 10).Expand());
+
+  SetSizerAndFit(sizer);
+}
+
+void CaptureSearch::bindEvents() {
+  Bind(wxEVT_CHOICE, [&](wxCommandEvent&) { updateRange(); }, ID_Session);
+  Bind(wxEVT_BUTTON, [&](wxCommandEvent&) { search(); }, ID_Search);
+  Bind(wxEVT_TEXT_ENTER, [&](wxCommandEvent&) { search(); }, ID_Search);
+  Bind(wxEVT_CLOSE_WINDOW, [&](wxCloseEvent& event) {
+    if (searching && event.CanVeto()) {
+      event.Veto();
+      return;
+    }
+    event.Skip();
+  });
+}
+
+void CaptureSearch::updateSessions(const std::string& select) {
+  auto current = select.empty() ? sessionSelect->GetStringSelection() : wxString(select);
+  sessionSelect->Clear();
+  for (const auto& session : SerialCapture::getSessions()) sessionSelect->Append(session);
+
+  if (!sessionSelect->SetStringSelection(current) && sessionSelect->GetCount() != 0) sessionSelect->SetSelection(0);
+  updateRange();
+}
+
+void CaptureSearch::updateRange() {
+  from->Clear();
+  to->Clear();
+
+  auto segments = SerialCapture::loadIndex(sessionSelect->GetStringSelection().ToStdString());
+  uint64_t lines{0};
+  for (const auto& segment : segments) lines += segment.lines;
+  if (lines == 0) {
+    status->SetLabel(sessionSelect->GetCount() == 0 ? "No captures yet." : "Nothing was captured.");
+    return;
+  }
+
+  int64_t first{std::numeric_limits<int64_t>::max()};
+  int64_t last{std::numeric_limits<int64_t>::min()};
+  for (const auto& segment : segments) {
+    if (segment.lines == 0) continue;
+    first = std::min(first, segment.first);
+    last = std::max(last, segment.last);
+  }
+  // Rounded out to the second, as that's what's typed in
+  from->SetValue(SerialCapture::formatTime(first).substr(0, 19));
+  to->SetValue(SerialCapture::formatTime(last + 1000).substr(0, 19));
+  status->SetLabel(wxString::Format("%llu lines in %llu files.", static_cast<unsigned long long>(lines), static_cast<unsigned long long>(segments.size())));
+}
+
+void CaptureSearch::search() {
+  if (searching || sessionSelect->GetSelection() == wxNOT_FOUND) return;
+
+  int64_t start{std::numeric_limits<int64_t>::min()};
+  int64_t end{std::numeric_limits<int64_t>::max()};
+  if ((!from->IsEmpty() && !SerialCapture::parseTime(from->GetValue().ToStdString(), start)) ||
+      (!to->IsEmpty() && !SerialCapture::parseTime(to->GetValue().ToStdString(), end))) {
+    status->SetLabel("Times must be written as YYYY-MM-DD HH:MM:SS.");
+    return;
+  }
+
+  searching = true;
+  searchButton->Disable();
+  status->SetLabel("Searching...");
+  results->clear();
+
+  auto session = sessionSelect->GetStringSelection().ToStdString();
+  auto query = std::string(pattern->GetValue().utf8_str());
+  new ThreadRunner([=]() {
+    std::vector<SerialCapture::Line> found;
+    std::string error;
+    auto success = SerialCapture::search(session, start, end, query, SEARCH_LIMIT, found, error);
+
+    wxString text;
+    for (const auto& line : found) text += SerialCapture::formatTime(line.time) + ' ' + wxString::FromUTF8(line.text) + '\n';
+
+    CallAfter([=]() {
+      searching = false;
+      searchButton->Enable();
+      if (!success) {
+        status->SetLabel(error);
+        return;
+      }
+      results->append(text);
+      status->SetLabel(found.size() == SEARCH_LIMIT ? wxString::Format("Showing the first %d matching lines.", SEARCH_LIMIT) : wxString::Format("%llu matching lines.", static_cast<unsigned long long>(found.size())));
+    });
+  });
+}
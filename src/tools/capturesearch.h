@@ -0,0 +1,51 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include "mainmenu/mainmenu.h"
+#include "ui/logview.h"
+
+#include <string>
+
+#include <wx/button.h>
+#include <wx/choice.h>
+#include <wx/frame.h>
+#include <wx/stattext.h>
+#include <wx/textctrl.h>
+
+// Looks through serial captures by time range and/or regex. Only the capture's index is read
+// until a search runs, and then only the segments covering the time range.
+class CaptureSearch : public wxFrame {
+public:
+  // Brings up the search (opening it if needed), on `session` if given
+  static void show(MainMenu*, const std::string& session = {});
+  static CaptureSearch* instance;
+
+  CaptureSearch(MainMenu*);
+  ~CaptureSearch();
+
+private:
+  enum {
+    ID_Session,
+    ID_Search,
+  };
+
+  wxChoice* sessionSelect{nullptr};
+  wxTextCtrl* from{nullptr};
+  wxTextCtrl* to{nullptr};
+  wxTextCtrl* pattern{nullptr};
+  wxButton* searchButton{nullptr};
+  wxStaticText* status{nullptr};
+  LogView* results{nullptr};
+  // Closing waits for a search to finish, it reports back to this window
+  bool searching{false};
+
+  void createUI();
+  void bindEvents();
+
+  void updateSessions(const std::string& select);
+  // Fills in the whole time range of the selected capture
+  void updateRange();
+  void search();
+};
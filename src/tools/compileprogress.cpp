@@ -0,0 +1,216 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "tools/compileprogress.h"
+
+#include "core/defines.h"
+#include "core/utilities/hash.h"
+
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <locale>
+#include <sstream>
+#include <vector>
+
+// Enough history to spot a regression across ProffieOS updates without the file growing forever
+#define MAX_TIMINGS 1000
+
+std::mutex CompileProgress::fileLock;
+
+// Used until a config/board has been built once; roughly a clean V3 build on a laptop.
+static constexpr std::array<double, CompileProgress::NUM_STAGES> DEFAULT_SECONDS{ 15, 60, 5, 30, 5, 2 };
+static constexpr std::array<int32_t, CompileProgress::NUM_STAGES> DEFAULT_UNITS{ 40, 2, 3, 80, 1, 2 };
+
+CompileProgress::CompileProgress(const std::string& _config, const std::string& _fqbn, const std::string& _boardOptions) :
+  config(_config), fqbn(_fqbn), boardOptions(_boardOptions) {
+  key = Hash().add(config).add('\0').add(fqbn).add('\0').add(boardOptions).hex();
+  hasPrevious = loadPrevious();
+  if (!hasPrevious) {
+    previous.seconds = DEFAULT_SECONDS;
+    previous.units = DEFAULT_UNITS;
+  }
+
+  start = stageStart = Clock::now();
+}
+
+std::string CompileProgress::stageName(Stage stage) {
+  switch (stage) {
+    case DISCOVERY:
+      return "Detecting libraries";
+    case SKETCH:
+      return "Compiling sketch";
+    case LIBRARIES:
+      return "Compiling libraries";
+    case CORE:
+      return "Compiling core";
+    case LINK:
+      return "Linking";
+    case OBJCOPY:
+      return "Creating firmware";
+    default:
+      return {};
+  }
+}
+
+bool CompileProgress::update(const Arduino::CLIEvent& event) {
+  const auto& text = event.text;
+  auto startsWith = [&](const char* prefix) { return text.rfind(prefix, 0) == 0; };
+
+  if (startsWith("Detecting libraries used")) setStage(DISCOVERY);
+  else if (startsWith("Compiling sketch")) setStage(SKETCH);
+  else if (startsWith("Compiling libraries")) setStage(LIBRARIES);
+  else if (startsWith("Compiling core")) setStage(CORE);
+  else if (startsWith("Linking everything together")) setStage(LINK);
+  else if (text.find("objcopy") != std::string::npos) {
+    setStage(OBJCOPY);
+    current.units[OBJCOPY]++;
+  } else if (startsWith("Using previously compiled file") || startsWith("Using cached library dependencies")) {
+    current.units[stage]++;
+  } else if ((text.find("g++") != std::string::npos || text.find("gcc") != std::string::npos) && text.find(" -o ") != std::string::npos) {
+    current.units[stage]++;
+  } else return false;
+
+  return true;
+}
+
+void CompileProgress::setStage(Stage newStage) {
+  if (newStage == stage) return;
+  // Stages only go forward, and one that never showed up (e.g. a precompiled core) took no time
+  if (newStage < stage) return;
+
+  auto now = Clock::now();
+  current.seconds[stage] += std::chrono::duration<double>(now - stageStart).count();
+  stageStart = now;
+  stage = newStage;
+}
+
+double CompileProgress::getStageFraction() {
+  auto expectedUnits = previous.units[stage];
+  auto expectedSeconds = previous.seconds[stage];
+  auto elapsed = std::chrono::duration<double>(Clock::now() - stageStart).count();
+
+  // Units are the better measure for stages with lots of them, time for the one-big-file ones
+  double unitFraction = expectedUnits > 0 ? static_cast<double>(current.units[stage]) / expectedUnits : 0;
+  double timeFraction = expectedSeconds > 0 ? elapsed / expectedSeconds : 0;
+  return std::min(0.95, std::max(unitFraction, timeFraction));
+}
+
+double CompileProgress::getExpectedTotal() {
+  double total{0};
+  for (const auto seconds : previous.seconds) total += seconds;
+  return total;
+}
+
+double CompileProgress::getFraction() {
+  auto total = getExpectedTotal();
+  if (total <= 0) return lastFraction;
+
+  double done{0};
+  for (int32_t idx = 0; idx < stage; idx++) done += previous.seconds[idx];
+  done += previous.seconds[stage] * getStageFraction();
+
+  lastFraction = std::max(lastFraction, std::min(0.99, done / total));
+  return lastFraction;
+}
+
+std::string CompileProgress::describe() {
+  std::ostringstream description;
+  description << stageName(stage) << "...";
+  if (previous.units[stage] > 1) description << " (" << current.units[stage] << "/" << std::max(current.units[stage], previous.units[stage]) << ")";
+
+  auto fraction = getFraction();
+  auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  if (fraction > 0.02) {
+    // Scale the expected remainder by how this build is going compared to the last one
+    auto expectedElapsed = fraction * getExpectedTotal();
+    auto pace = expectedElapsed > 0 ? elapsed / expectedElapsed : 1;
+    auto remaining = static_cast<int32_t>((1 - fraction) * getExpectedTotal() * pace);
+    description << "\nAbout " << remaining / 60 << ":" << (remaining % 60 < 10 ? "0" : "") << remaining % 60 << " left";
+    if (!hasPrevious) description << " (first build, rough estimate)";
+  }
+
+  return description.str();
+}
+
+void CompileProgress::finish() {
+  current.seconds[stage] += std::chrono::duration<double>(Clock::now() - stageStart).count();
+  stageStart = Clock::now();
+
+  std::ostringstream line;
+  line.imbue(std::locale::classic());
+  line << key << '\t' << config << '\t' << fqbn << '\t' << boardOptions << '\t' << std::time(nullptr);
+  for (int32_t idx = 0; idx < NUM_STAGES; idx++) {
+    line << '\t' << stageName(static_cast<Stage>(idx)) << ':' << current.seconds[idx] << ':' << current.units[idx];
+  }
+
+  std::lock_guard<std::mutex> guard(fileLock);
+  std::vector<std::string> lines;
+  {
+    std::ifstream timings(COMPILETIMES_PATH);
+    std::string existing;
+    while (std::getline(timings, existing)) if (!existing.empty()) lines.push_back(existing);
+  }
+  lines.push_back(line.str());
+  if (lines.size() > MAX_TIMINGS) lines.erase(lines.begin(), lines.end() - MAX_TIMINGS);
+
+  std::ofstream timings(COMPILETIMES_PATH ".tmp");
+  if (!timings.is_open()) {
+    std::cerr << "Error creating temporary compile timings file." << std::endl;
+    return;
+  }
+  for (const auto& entry : lines) timings << entry << std::endl;
+  timings.close();
+
+  remove(COMPILETIMES_PATH);
+  if (rename(COMPILETIMES_PATH ".tmp", COMPILETIMES_PATH) != 0) {
+    std::cerr << "Error saving compile timings file." << std::endl;
+  }
+}
+
+bool CompileProgress::loadPrevious() {
+  std::lock_guard<std::mutex> guard(fileLock);
+  std::ifstream timings(COMPILETIMES_PATH);
+  if (!timings.is_open()) return false;
+
+  // Last matching entry wins
+  bool found{false};
+  std::string line;
+  while (std::getline(timings, line)) {
+    if (line.compare(0, key.size() + 1, key + '\t') != 0) continue;
+
+    std::vector<std::string> fields;
+    std::istringstream lineStream(line);
+    std::string field;
+    while (std::getline(lineStream, field, '\t')) fields.push_back(field);
+    if (fields.size() != 5 + NUM_STAGES) continue;
+
+    Timing timing;
+    bool valid{true};
+    for (int32_t idx = 0; idx < NUM_STAGES; idx++) {
+      auto stageField = fields[5 + idx];
+      auto unitsSep = stageField.rfind(':');
+      auto secondsSep = stageField.rfind(':', unitsSep - 1);
+      if (unitsSep == std::string::npos || secondsSep == std::string::npos) {
+        valid = false;
+        break;
+      }
+      // Not stod, that follows the C locale, which GTK sets from the environment
+      std::istringstream seconds(stageField.substr(secondsSep + 1, unitsSep - secondsSep - 1));
+      std::istringstream units(stageField.substr(unitsSep + 1));
+      seconds.imbue(std::locale::classic());
+      units.imbue(std::locale::classic());
+      if (!(seconds >> timing.seconds[idx]) || !(units >> timing.units[idx])) {
+        valid = false;
+        break;
+      }
+    }
+    if (!valid) continue;
+
+    previous = timing;
+    found = true;
+  }
+
+  return found;
+}
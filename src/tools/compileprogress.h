@@ -0,0 +1,70 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include "tools/arduino.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// Follows arduino-cli's verbose compile output through the build stages, estimating overall
+// progress and time remaining from the previous build of the same config/board, and keeps
+// every successful build's stage timings in COMPILETIMES_PATH.
+class CompileProgress {
+public:
+  enum Stage {
+    DISCOVERY,
+    SKETCH,
+    LIBRARIES,
+    CORE,
+    LINK,
+    OBJCOPY,
+    NUM_STAGES
+  };
+
+  CompileProgress(const std::string& config, const std::string& fqbn, const std::string& boardOptions);
+
+  // True if the line changed anything worth showing
+  bool update(const Arduino::CLIEvent&);
+  // 0-1, never goes backwards
+  double getFraction();
+  // e.g. "Compiling core... (12/80), about 1:05 left"
+  std::string describe();
+  // Stores this build's timings, call only for successful builds.
+  void finish();
+
+  static std::string stageName(Stage);
+
+private:
+  typedef std::chrono::steady_clock Clock;
+
+  struct Timing {
+    std::array<double, NUM_STAGES> seconds{};
+    std::array<int32_t, NUM_STAGES> units{};
+  };
+
+  std::string key;
+  std::string config;
+  std::string fqbn;
+  std::string boardOptions;
+
+  Timing previous{};
+  bool hasPrevious{false};
+  Timing current{};
+
+  Stage stage{DISCOVERY};
+  Clock::time_point start;
+  Clock::time_point stageStart;
+  double lastFraction{0};
+
+  void setStage(Stage);
+  double getStageFraction();
+  double getExpectedTotal();
+
+  bool loadPrevious();
+  static std::mutex fileLock;
+};
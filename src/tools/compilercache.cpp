@@ -0,0 +1,203 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "tools/compilercache.h"
+
+#include "core/defines.h"
+#include "core/appstate.h"
+#include "core/utilities/hash.h"
+#include "tools/process.h"
+#include "tools/toolchain.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <wx/dir.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/utils.h>
+
+#ifndef __WXMSW__
+#include <sys/stat.h>
+#endif
+
+#define REPORT_PREFIX "Compiler cache: "
+// The cache for one ProffieOS version; ccache evicts past this itself
+#define COMPILERCACHE_MAXSIZE "2G"
+
+std::mutex CompilerCache::lock;
+std::string CompilerCache::ccachePath;
+std::string CompilerCache::cacheDir;
+std::map<std::string, std::string> CompilerCache::wrapperDirs;
+
+void CompilerCache::init() {
+# ifndef __WXMSW__
+  wxPathList path;
+  path.AddEnvList("PATH");
+  ccachePath = path.FindAbsoluteValidPath("ccache").ToStdString();
+  if (ccachePath.empty()) return;
+
+  // Objects from another ProffieOS or core version will never be hit again
+  auto version = std::string(PROFFIEOS_VERSION) + "-" + ARDUINO_PBPLUGIN_VERSION;
+  wxDir cachesDir(COMPILERCACHE_PATH);
+  if (cachesDir.IsOpened()) {
+    std::vector<wxString> stale;
+    wxString name;
+    for (bool found = cachesDir.GetFirst(&name, wxEmptyString, wxDIR_DIRS | wxDIR_HIDDEN); found; found = cachesDir.GetNext(&name)) {
+      if (name != version) stale.push_back(name);
+    }
+    for (const auto& dir : stale) {
+      auto staleDir = wxFileName::DirName(COMPILERCACHE_PATH);
+      staleDir.AppendDir(dir);
+      if (!staleDir.Rmdir(wxPATH_RMDIR_RECURSIVE)) std::cerr << "Failed to remove old compiler cache " << staleDir.GetPath() << std::endl;
+    }
+  }
+
+  auto dir = wxFileName::DirName(COMPILERCACHE_PATH);
+  dir.AppendDir(version);
+  dir.MakeAbsolute();
+  if (!dir.DirExists() && !dir.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL)) {
+    std::cerr << "Failed to create compiler cache directory, building uncached..." << std::endl;
+    ccachePath.clear();
+    return;
+  }
+  cacheDir = dir.GetPath().ToStdString();
+
+  // Every config builds in its own directory, so paths are made relative to all of them or nothing would be shared
+  auto baseDir = wxFileName::DirName(RESOURCES_PATH);
+  baseDir.MakeAbsolute();
+  wxSetEnv("CCACHE_DIR", cacheDir);
+  wxSetEnv("CCACHE_BASEDIR", baseDir.GetPath());
+  wxSetEnv("CCACHE_MAXSIZE", COMPILERCACHE_MAXSIZE);
+# endif
+}
+
+bool CompilerCache::isAvailable() { return !ccachePath.empty(); }
+bool CompilerCache::isEnabled() { return isAvailable() && AppState::instance->compilerCache; }
+
+std::vector<std::string> CompilerCache::getBuildArgs(const std::string& fqbn, const std::string& boardOptions, const std::string& sketch) {
+  if (!isEnabled()) return {};
+
+  std::lock_guard<std::mutex> guard(lock);
+  auto wrapperDir = wrapperDirs.find(fqbn);
+  if (wrapperDir == wrapperDirs.end()) {
+    // The real compiler location and tool names, as this core resolves them
+    auto properties = Toolchain::get()->getBuildProperties(fqbn, boardOptions, sketch);
+    auto compilerPath = properties.find("compiler.path");
+    if (compilerPath == properties.end() || compilerPath->second.empty()) {
+      std::cerr << "Could not find the compiler for " << fqbn << ", building uncached..." << std::endl;
+      return {};
+    }
+
+    auto dir = wxFileName::DirName(cacheDir);
+    dir.AppendDir("wrappers");
+    dir.AppendDir(Hash().add(fqbn).add('\0').add(compilerPath->second).hex());
+    if (!dir.DirExists() && !dir.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL)) return {};
+
+    // Everything the core runs from compiler.path needs a wrapper, only the compilers are cached.
+    // The linker is usually g++ too, ccache passes those calls straight through.
+    std::map<std::string, bool> tools;
+    for (const auto& [ key, tool ] : properties) {
+      if (key.rfind("compiler.", 0) != 0 || key.size() < 4 || key.compare(key.size() - 4, 4, ".cmd") != 0 || tool.empty()) continue;
+      tools[tool] |= key == "compiler.c.cmd" || key == "compiler.cpp.cmd";
+    }
+    for (const auto& [ tool, cached ] : tools) {
+      if (!writeWrapper(wxFileName(dir.GetPath(), tool).GetFullPath().ToStdString(), compilerPath->second + tool, cached)) return {};
+    }
+
+    auto path = dir.GetPath(wxPATH_GET_SEPARATOR).ToStdString();
+    wrapperDir = wrapperDirs.emplace(fqbn, path).first;
+  }
+
+  return { "--build-property", "compiler.path=" + wrapperDir->second };
+}
+
+bool CompilerCache::writeWrapper(const std::string& path, const std::string& target, bool cached) {
+# ifdef __WXMSW__
+  return false;
+# else
+  auto quote = [](const std::string& text) {
+    std::string quoted{"'"};
+    for (const char chr : text) {
+      if (chr == '\'') quoted += "'\\''";
+      else quoted += chr;
+    }
+    return quoted + "'";
+  };
+
+  std::string script{"#!/bin/sh\nexec "};
+  if (cached) script += quote(ccachePath) + " ";
+  script += quote(target) + " \"$@\"\n";
+
+  // Only rewritten when it changes, so it isn't racing a build using it
+  std::ifstream existing(path, std::ios::binary);
+  std::ostringstream existingScript;
+  existingScript << existing.rdbuf();
+  if (existing.is_open() && existingScript.str() == script) return true;
+  existing.close();
+
+  std::ofstream wrapper(path + ".tmp", std::ios::binary);
+  wrapper << script;
+  wrapper.close();
+  if (!wrapper || chmod((path + ".tmp").c_str(), 0755) != 0 || !wxRenameFile(path + ".tmp", path, true)) {
+    std::cerr << "Failed to write compiler wrapper " << path << std::endl;
+    return false;
+  }
+  return true;
+# endif
+}
+
+CompilerCache::Stats CompilerCache::getStats() {
+  Stats stats;
+  if (!isEnabled()) return stats;
+
+  // ccache 4 has machine readable stats, 3 only the table
+  std::map<std::string, uint64_t> counters;
+  auto read = [&](const std::vector<std::string>& args, char separator) {
+    Process ccache;
+    if (!ccache.start(args)) return false;
+    Process::Line line;
+    while (ccache.readLine(line)) {
+      auto split = line.text.find_last_of(separator == '\t' ? "\t" : " ");
+      if (split == std::string::npos) continue;
+      auto key = line.text.substr(0, line.text.find_last_not_of(' ', split) + 1);
+      try {
+        counters[key] = std::stoull(line.text.substr(split + 1));
+      } catch (const std::exception&) {}
+    }
+    return ccache.finish() == 0;
+  };
+
+  if (read({ ccachePath, "--print-stats" }, '\t')) {
+    stats.hits = counters["direct_cache_hit"] + counters["preprocessed_cache_hit"];
+    stats.misses = counters["cache_miss"];
+    stats.valid = true;
+    return stats;
+  }
+
+  counters.clear();
+  if (read({ ccachePath, "-s" }, ' ')) {
+    stats.hits = counters["cache hit (direct)"] + counters["cache hit (preprocessed)"];
+    stats.misses = counters["cache miss"];
+    stats.valid = true;
+  }
+  return stats;
+}
+
+std::string CompilerCache::describe(const Stats& before, const Stats& after) {
+  if (!before.valid || !after.valid || after.hits < before.hits || after.misses < before.misses) return {};
+  auto hits = after.hits - before.hits;
+  auto total = hits + after.misses - before.misses;
+  if (total == 0) return {};
+
+  std::ostringstream report;
+  report << REPORT_PREFIX << hits << " of " << total << " compiles cached (" << hits * 100 / total << "%)";
+  return report.str();
+}
+
+std::string CompilerCache::findReport(const std::string& output) {
+  auto start = output.rfind(REPORT_PREFIX);
+  if (start == std::string::npos) return {};
+  return output.substr(start, output.find('\n', start) - start);
+}
@@ -0,0 +1,53 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Routes the compiler calls in ProffieOS builds through ccache, if it's installed and turned on
+// (see AppState::compilerCache), so the template-heavy ProffieOS headers aren't recompiled from
+// scratch for every config and board. The core's compiler.path is pointed at a directory of
+// wrapper scripts, one per tool, with the C/C++ compilers going through ccache. There's one cache
+// directory per ProffieOS and core version, older ones are deleted.
+//
+// Not on Windows, where arduino-cli would need real executables as wrappers.
+class CompilerCache {
+public:
+  // Finds ccache and sets up the cache directory (and the CCACHE_* environment arduino-cli passes on)
+  static void init();
+  static bool isAvailable();
+  // Available, and turned on
+  static bool isEnabled();
+
+  // Extra arduino-cli compile args for fqbn; empty if the wrappers can't be set up, in which case the build just runs uncached.
+  static std::vector<std::string> getBuildArgs(const std::string& fqbn, const std::string& boardOptions, const std::string& sketch);
+
+  struct Stats {
+    bool valid{false};
+    uint64_t hits{0};
+    uint64_t misses{0};
+  };
+  // Totals since the cache was created. Diffs between two calls count anything else compiling at the same time, too.
+  static Stats getStats();
+  // A one line hit rate report, as compile appends to its output; empty if either is invalid or nothing was compiled.
+  static std::string describe(const Stats& before, const Stats& after);
+  // Finds that line again in compile output, empty if there isn't one
+  static std::string findReport(const std::string& output);
+
+private:
+  CompilerCache();
+  CompilerCache(const CompilerCache&) = delete;
+
+  static bool writeWrapper(const std::string& path, const std::string& target, bool cached);
+
+  static std::mutex lock;
+  static std::string ccachePath;
+  static std::string cacheDir;
+  // Wrapper directory for each fqbn that's been set up this session
+  static std::map<std::string, std::string> wrapperDirs;
+};
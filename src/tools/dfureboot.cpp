@@ -0,0 +1,197 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "tools/dfureboot.h"
+
+#ifdef __linux__
+
+#include "tools/boardwatch.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <fcntl.h>
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <unistd.h>
+#include <wx/dir.h>
+
+#define USBDEVICE_DIR "/dev/bus/usb"
+// Only used when neither device events nor inotify are available
+#define FALLBACK_INTERVAL 250
+
+DFUReboot::DFUReboot(std::vector<std::string> watchDirs) {
+  ueventFd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_KOBJECT_UEVENT);
+  if (ueventFd >= 0) {
+    sockaddr_nl address{};
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = 1; // Kernel events
+    if (bind(ueventFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+      close(ueventFd);
+      ueventFd = -1;
+    }
+  }
+
+  if (watchDirs.empty()) {
+    // Device nodes are created in the directory for their bus
+    watchDirs.push_back(USBDEVICE_DIR);
+    wxDir buses(USBDEVICE_DIR);
+    wxString bus;
+    for (bool more = buses.IsOpened() && buses.GetFirst(&bus, wxEmptyString, wxDIR_DIRS); more; more = buses.GetNext(&bus)) {
+      watchDirs.push_back(USBDEVICE_DIR "/" + bus.ToStdString());
+    }
+  }
+
+  inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (inotifyFd >= 0) {
+    // The kernel announces the device before udev gives it the permissions an upload needs, which shows up as IN_ATTRIB
+    bool watching{false};
+    for (const auto& dir : watchDirs) {
+      if (inotify_add_watch(inotifyFd, dir.c_str(), IN_CREATE | IN_ATTRIB | IN_MOVED_TO) >= 0) watching = true;
+    }
+    if (!watching) {
+      close(inotifyFd);
+      inotifyFd = -1;
+    }
+  }
+
+  if (ueventFd < 0 && inotifyFd < 0) std::cerr << "Could not watch for device events, checking for the bootloader periodically." << std::endl;
+}
+
+DFUReboot::~DFUReboot() {
+  if (ueventFd >= 0) close(ueventFd);
+  if (inotifyFd >= 0) close(inotifyFd);
+}
+
+bool DFUReboot::send(const std::string& port, std::string& error) {
+  auto fd = open(port.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+  if (fd < 0) {
+    error = "Could not open " + port + ": " + std::strerror(errno);
+    return false;
+  }
+
+  termios settings{};
+  if (tcgetattr(fd, &settings) != 0) {
+    error = port + " is not a serial port: " + std::strerror(errno);
+    close(fd);
+    return false;
+  }
+  cfmakeraw(&settings);
+  cfsetispeed(&settings, B115200);
+  cfsetospeed(&settings, B115200);
+  settings.c_cflag |= CLOCAL | CREAD;
+  tcsetattr(fd, TCSANOW, &settings);
+
+  const std::string command{"RebootDFU\r\n"};
+  size_t written{0};
+  while (written < command.size()) {
+    auto res = write(fd, command.data() + written, command.size() - written);
+    if (res >= 0) {
+      written += res;
+      continue;
+    }
+    if (errno == EINTR) continue;
+
+    pollfd output{ fd, POLLOUT, 0 };
+    if (errno != EAGAIN || poll(&output, 1, 1000) <= 0) {
+      error = "Could not write to " + port + ": " + (errno == EAGAIN ? std::string("timed out") : std::strerror(errno));
+      close(fd);
+      return false;
+    }
+  }
+
+  // The board may well be gone by the time this returns, so whatever it says doesn't matter
+  tcdrain(fd);
+  close(fd);
+  return true;
+}
+
+bool DFUReboot::wait(const std::function<bool()>& present, std::chrono::milliseconds timeout) {
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+  char buffer[8192];
+
+  while (!present()) {
+    auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+    if (remaining <= 0) return false;
+    if (ueventFd < 0 && inotifyFd < 0) remaining = std::min<decltype(remaining)>(remaining, FALLBACK_INTERVAL);
+
+    // Negative fds are skipped by poll
+    pollfd fds[2]{ { ueventFd, POLLIN, 0 }, { inotifyFd, POLLIN, 0 } };
+    if (poll(fds, 2, static_cast<int32_t>(remaining)) < 0 && errno != EINTR) return false;
+
+    // Drained so the next poll sleeps until something else happens
+    for (const auto& fd : fds) {
+      if (fd.fd >= 0 && (fd.revents & POLLIN)) while (read(fd.fd, buffer, sizeof(buffer)) > 0) {}
+    }
+  }
+
+  return true;
+}
+
+bool DFUReboot::run(const std::string& port, std::string& error, std::chrono::milliseconds timeout) {
+  auto readAttribute = [](const std::string& path) {
+    std::ifstream file(path);
+    std::string value;
+    std::getline(file, value);
+    return value;
+  };
+  // Only counts once udev has made the device node usable, otherwise the upload would fail on permissions
+  auto usable = [&](const std::string& address) {
+    auto device = "/sys/bus/usb/devices/" + address + "/";
+    auto bus = readAttribute(device + "busnum");
+    auto number = readAttribute(device + "devnum");
+    if (bus.empty() || number.empty()) return true;
+
+    char node[64];
+    std::snprintf(node, sizeof(node), USBDEVICE_DIR "/%03d/%03d", std::atoi(bus.c_str()), std::atoi(number.c_str()));
+    if (access(node, R_OK | W_OK) == 0) return true;
+    // No device nodes at all, nothing to wait for
+    return access(USBDEVICE_DIR, F_OK) != 0;
+  };
+  auto bootloaders = []() {
+    std::vector<std::string> found;
+    for (const auto& [ address, entry ] : BoardWatch::scanSysfs()) {
+      if (entry.protocol == "dfu") found.push_back(address);
+    }
+    return found;
+  };
+
+  // One that was already there isn't the board being rebooted
+  auto before = bootloaders();
+  auto start = std::chrono::steady_clock::now();
+  auto elapsed = [&]() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+  };
+
+  DFUReboot reboot;
+  if (!reboot.send(port, error)) {
+    std::cerr << "Reboot to DFU: " << error << std::endl;
+    return false;
+  }
+  auto sent = elapsed();
+  std::cerr << "Reboot to DFU: command sent to " << port << " in " << sent << "ms" << std::endl;
+
+  auto found = reboot.wait([&]() {
+    for (const auto& address : bootloaders()) {
+      if (std::find(before.begin(), before.end(), address) == before.end() && usable(address)) return true;
+    }
+    return false;
+  }, timeout);
+  if (!found) {
+    error = "The Proffieboard did not show up in bootloader mode within " + std::to_string(timeout.count() / 1000) + " seconds.";
+    std::cerr << "Reboot to DFU: no bootloader after " << elapsed() - sent << "ms" << std::endl;
+    return false;
+  }
+
+  std::cerr << "Reboot to DFU: bootloader ready after " << elapsed() - sent << "ms" << std::endl;
+  return true;
+}
+
+#endif
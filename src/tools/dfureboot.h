@@ -0,0 +1,45 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#ifdef __linux__
+
+#include "core/defines.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Reboots a Proffieboard into its bootloader over its serial port, then waits for the bootloader to
+// enumerate. Waking on the kernel's device events (and inotify on the device directories) means the
+// upload can start the moment the board is ready instead of after a sleep long enough for the slowest one.
+//
+// Everything it touches can be swapped out, so it can be run against a pseudo-terminal and
+// a directory a stand-in device node gets created in.
+class DFUReboot {
+public:
+  // Subscribes to events right away, so the bootloader can't appear unnoticed before wait() is called.
+  // `watchDirs` are watched for new entries; empty means the USB bus directories under /dev/bus/usb.
+  DFUReboot(std::vector<std::string> watchDirs = {});
+  ~DFUReboot();
+
+  // Opens the tty, sets it up raw at 115200 and writes the reboot command.
+  bool send(const std::string& port, std::string& error);
+  // Returns as soon as `present` is true, checking it again after every event; false once `timeout` is up.
+  bool wait(const std::function<bool()>& present, std::chrono::milliseconds timeout);
+
+  // The whole sequence for a board on `port`, true once a new bootloader is present.
+  // Each phase is timed and written to the log.
+  static bool run(const std::string& port, std::string& error, std::chrono::milliseconds timeout = std::chrono::milliseconds(DFUREBOOT_TIMEOUT));
+
+private:
+  DFUReboot(const DFUReboot&) = delete;
+
+  int32_t ueventFd{-1};
+  int32_t inotifyFd{-1};
+};
+
+#endif
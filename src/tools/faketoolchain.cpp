@@ -0,0 +1,139 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "tools/faketoolchain.h"
+
+#include <fstream>
+#include <iostream>
+#include <locale>
+#include <sstream>
+#include <thread>
+
+FakeToolchain::FakeToolchain(const std::string& scriptPath) {
+  if (!load(scriptPath)) std::cerr << "Fake toolchain script " << scriptPath << " could not be loaded, every run will fail." << std::endl;
+}
+
+bool FakeToolchain::load(const std::string& scriptPath) {
+  std::ifstream script(scriptPath);
+  if (!script.is_open()) return false;
+
+  int32_t seed{0};
+  std::string line;
+  int32_t lineNum{0};
+  while (std::getline(script, line)) {
+    lineNum++;
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    if (line.empty() || line[0] == '#') continue;
+
+    auto split = line.find(' ');
+    auto directive = line.substr(0, split);
+    auto argument = split == std::string::npos ? std::string{} : line.substr(split + 1);
+    std::istringstream arguments(argument);
+    arguments.imbue(std::locale::classic());
+
+    Step step;
+    if (directive == "SEED") {
+      arguments >> seed;
+      continue;
+    } else if (directive == "SPEED") {
+      arguments >> speed;
+      if (speed <= 0) speed = 1;
+      continue;
+    } else if (directive == "MATCH") {
+      Block block;
+      for (std::string word; arguments >> word;) block.match.push_back(word);
+      blocks.push_back(block);
+      continue;
+    } else if (directive == "DELAY") {
+      step.type = Step::Type::DELAY;
+      arguments >> step.value;
+    } else if (directive == "OUT" || directive == "ERR") {
+      step.type = Step::Type::OUTPUT;
+      step.stream = directive == "OUT" ? Process::Stream::STDOUT : Process::Stream::STDERR;
+      step.text = argument;
+    } else if (directive == "FAIL") {
+      step.type = Step::Type::FAIL;
+      step.value = 1;
+      arguments >> step.chance >> step.value;
+    } else if (directive == "EXIT") {
+      step.type = Step::Type::EXIT;
+      arguments >> step.value;
+    } else {
+      std::cerr << "Fake toolchain script line " << lineNum << ": unknown directive \"" << directive << "\", skipping..." << std::endl;
+      continue;
+    }
+
+    if (blocks.empty()) {
+      std::cerr << "Fake toolchain script line " << lineNum << ": \"" << directive << "\" before any MATCH, skipping..." << std::endl;
+      continue;
+    }
+    blocks.back().steps.push_back(step);
+  }
+
+  random.seed(seed);
+  return true;
+}
+
+int32_t FakeToolchain::run(const std::vector<std::string>& args, const std::function<void(const Process::Line&)>& handler, Cancellation* cancel, bool) {
+  auto matches = [&](const Block& block) {
+    if (block.match.size() > args.size()) return false;
+    for (size_t idx = 0; idx < block.match.size(); idx++) {
+      if (block.match[idx] != args[idx]) return false;
+    }
+    return true;
+  };
+
+  const Block* block{nullptr};
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    std::vector<const Block*> candidates;
+    const std::vector<std::string>* firstMatch{nullptr};
+    for (const auto& candidate : blocks) {
+      if (!matches(candidate)) continue;
+      if (firstMatch == nullptr) firstMatch = &candidate.match;
+      if (candidate.match == *firstMatch) candidates.push_back(&candidate);
+    }
+
+    if (!candidates.empty()) {
+      std::string key;
+      for (const auto& word : *firstMatch) key += word + ' ';
+      block = candidates[plays[key]++ % candidates.size()];
+    }
+  }
+  if (block == nullptr) {
+    std::string command;
+    for (const auto& arg : args) command += ' ' + arg;
+    handler({ Process::Stream::STDERR, "Fake toolchain has no MATCH for:" + command });
+    return 1;
+  }
+
+  for (const auto& step : block->steps) {
+    if (cancel != nullptr && cancel->isCancelled()) return -1;
+
+    switch (step.type) {
+      case Step::Type::DELAY: {
+        std::chrono::milliseconds duration(static_cast<int64_t>(step.value / speed));
+        if (cancel != nullptr) {
+          if (!cancel->sleep(duration)) return -1;
+        } else std::this_thread::sleep_for(duration);
+        break;
+      }
+      case Step::Type::OUTPUT:
+        handler({ step.stream, step.text });
+        break;
+      case Step::Type::FAIL:
+        if (!rollFailure(step.chance)) break;
+        handler({ Process::Stream::STDERR, "Fake toolchain failure" });
+        return step.value;
+      case Step::Type::EXIT:
+        return step.value;
+    }
+  }
+
+  return 0;
+}
+
+bool FakeToolchain::rollFailure(double chance) {
+  std::lock_guard<std::mutex> guard(lock);
+  return std::uniform_real_distribution<double>(0, 100)(random) < chance;
+}
@@ -0,0 +1,59 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include "tools/toolchain.h"
+
+#include <map>
+#include <random>
+
+// Stands in for arduino-cli by playing back a script, one line per directive:
+//
+//   SEED 42                  random seed for FAIL (default 0), so runs are repeatable
+//   SPEED 4                  divides every DELAY (default 1)
+//   MATCH compile            starts a block for runs whose args begin with these words
+//   DELAY 250                waits this many milliseconds
+//   OUT Sketch uses ...      prints a line to stdout
+//   ERR some warning         prints a line to stderr
+//   FAIL 10 1                with 10% probability, exits with code 1 here
+//   EXIT 0                   exits with this code (the default at the end of a block)
+//
+// Blank lines and lines starting with '#' are ignored. The first MATCH that fits is used, so more
+// specific blocks go first; several blocks with the same MATCH are played in turn.
+// A run with no matching block prints an error and exits with 1.
+class FakeToolchain : public Toolchain {
+public:
+  FakeToolchain(const std::string& scriptPath);
+
+  int32_t run(const std::vector<std::string>&, const std::function<void(const Process::Line&)>&, Cancellation* = nullptr, bool lowPriority = false) override;
+  bool isSimulated() const override { return true; }
+
+private:
+  struct Step {
+    enum class Type {
+      DELAY,
+      OUTPUT,
+      FAIL,
+      EXIT
+    } type{Type::OUTPUT};
+    Process::Stream stream{Process::Stream::STDOUT};
+    std::string text{};
+    int32_t value{0};
+    double chance{0};
+  };
+  struct Block {
+    std::vector<std::string> match{};
+    std::vector<Step> steps{};
+  };
+
+  std::vector<Block> blocks{};
+  double speed{1};
+
+  std::mutex lock{};
+  std::mt19937 random{};
+  std::map<std::string, size_t> plays{};
+
+  bool load(const std::string& scriptPath);
+  bool rollFailure(double chance);
+};
@@ -0,0 +1,155 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "tools/firmwarecache.h"
+
+#include "core/defines.h"
+#include "core/utilities/hash.h"
+#include "editor/editorwindow.h"
+#include "tools/arduino.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <wx/datetime.h>
+#include <wx/dir.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+// Each entry is a few MB (mostly the .elf), and re-flashing usually cycles through a handful of configs.
+#define FIRMWARECACHE_MAXENTRIES 64
+#define FIRMWARECACHE_MARKER ".lastused"
+#define FIRMWARE_PREFIX "ProffieOS.ino."
+
+std::mutex FirmwareCache::lock;
+
+std::string FirmwareCache::getKey(EditorWindow* editor) {
+  return getKey(editor->getOpenConfig(), Arduino::getFQBN(editor), Arduino::getBoardOptions(editor), Arduino::getConfigSelect());
+}
+std::string FirmwareCache::getKey(const std::string& configName, const std::string& fqbn, const std::string& boardOptions, SketchOverlay::ConfigSelect configSelect) {
+  Hash hash;
+
+  std::ifstream config(CONFIG_DIR + configName + ".h", std::ios::binary);
+  if (!config.is_open()) return {};
+  std::ostringstream configData;
+  configData << config.rdbuf();
+  hash.add(configData.str()).add('\0');
+
+  hash.add(fqbn).add('\0');
+  hash.add(boardOptions).add('\0');
+  hash.add(PROFFIEOS_VERSION).add('\0');
+  hash.add(ARDUINO_PBPLUGIN_VERSION).add('\0');
+  // Only a patched ino gets the version string, so the two don't build the same firmware
+  hash.add(static_cast<char>(configSelect));
+  fingerprintTree(hash, PROFFIEOS_PATH, {});
+
+  return hash.hex();
+}
+
+void FirmwareCache::fingerprintTree(Hash& hash, const std::string& root, const std::string& relative) {
+  wxDir dir(relative.empty() ? root : root + wxString(wxFileName::GetPathSeparator()).ToStdString() + relative);
+  if (!dir.IsOpened()) return;
+
+  // wxDir order is filesystem-dependent
+  std::vector<std::string> files;
+  std::vector<std::string> dirs;
+  wxString name;
+  for (bool found = dir.GetFirst(&name, wxEmptyString, wxDIR_FILES | wxDIR_HIDDEN); found; found = dir.GetNext(&name)) files.push_back(name.ToStdString());
+  for (bool found = dir.GetFirst(&name, wxEmptyString, wxDIR_DIRS | wxDIR_HIDDEN); found; found = dir.GetNext(&name)) dirs.push_back(name.ToStdString());
+  std::sort(files.begin(), files.end());
+  std::sort(dirs.begin(), dirs.end());
+
+  for (const auto& file : files) {
+    auto path = relative.empty() ? file : relative + "/" + file;
+    // Size and mtime rather than contents; hashing all of ProffieOS on every build would cost more than it saves.
+    wxFileName fileName(dir.GetName(), file);
+    hash.add(path).add('\0');
+    hash.add(fileName.GetSize().ToString().ToStdString()).add('\0');
+    hash.add(std::to_string(fileName.GetModificationTime().GetTicks())).add('\0');
+  }
+  for (const auto& subdir : dirs) {
+    // The generated configs are covered by the config hash
+    if (relative.empty() && subdir == "config") continue;
+    fingerprintTree(hash, root, relative.empty() ? subdir : relative + "/" + subdir);
+  }
+}
+
+std::string FirmwareCache::find(const std::string& key) {
+  if (key.empty()) return {};
+  std::lock_guard<std::mutex> guard(lock);
+
+  wxFileName entry = wxFileName::DirName(FIRMWARECACHE_PATH);
+  entry.AppendDir(key);
+  entry.MakeAbsolute();
+  if (!entry.DirExists()) return {};
+
+  wxFileName(entry.GetPath(), FIRMWARECACHE_MARKER).Touch();
+  return entry.GetPath().ToStdString();
+}
+
+bool FirmwareCache::store(const std::string& key, const std::string& buildPath) {
+  if (key.empty()) return false;
+  std::lock_guard<std::mutex> guard(lock);
+
+  wxFileName entry = wxFileName::DirName(FIRMWARECACHE_PATH);
+  entry.AppendDir(key);
+  wxFileName staging = wxFileName::DirName(FIRMWARECACHE_PATH);
+  staging.AppendDir(key + ".tmp");
+
+  if (staging.DirExists()) wxFileName::Rmdir(staging.GetPath(), wxPATH_RMDIR_RECURSIVE);
+  if (!staging.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL)) {
+    std::cerr << "Failed to create firmware cache entry." << std::endl;
+    return false;
+  }
+
+  wxDir build(buildPath);
+  if (!build.IsOpened()) return false;
+  wxString name;
+  bool copied{false};
+  for (bool found = build.GetFirst(&name, FIRMWARE_PREFIX "*", wxDIR_FILES); found; found = build.GetNext(&name)) {
+    if (!wxCopyFile(wxFileName(buildPath, name).GetFullPath(), wxFileName(staging.GetPath(), name).GetFullPath())) {
+      std::cerr << "Failed to copy " << name << " into firmware cache." << std::endl;
+      wxFileName::Rmdir(staging.GetPath(), wxPATH_RMDIR_RECURSIVE);
+      return false;
+    }
+    copied = true;
+  }
+  if (!copied) {
+    std::cerr << "No firmware found in build directory to cache." << std::endl;
+    wxFileName::Rmdir(staging.GetPath(), wxPATH_RMDIR_RECURSIVE);
+    return false;
+  }
+  wxFileName(staging.GetPath(), FIRMWARECACHE_MARKER).Touch();
+
+  // Only ever expose complete entries
+  if (entry.DirExists()) wxFileName::Rmdir(entry.GetPath(), wxPATH_RMDIR_RECURSIVE);
+  if (!wxRenameFile(staging.GetPath(), entry.GetPath(), false)) {
+    std::cerr << "Failed to finalize firmware cache entry." << std::endl;
+    wxFileName::Rmdir(staging.GetPath(), wxPATH_RMDIR_RECURSIVE);
+    return false;
+  }
+
+  evict();
+  return true;
+}
+
+void FirmwareCache::evict() {
+  wxDir cacheDir(FIRMWARECACHE_PATH);
+  if (!cacheDir.IsOpened()) return;
+
+  std::vector<std::pair<wxDateTime, wxString>> entries;
+  wxString name;
+  for (bool found = cacheDir.GetFirst(&name, wxEmptyString, wxDIR_DIRS | wxDIR_HIDDEN); found; found = cacheDir.GetNext(&name)) {
+    wxFileName marker(wxFileName(FIRMWARECACHE_PATH, name).GetFullPath(), FIRMWARECACHE_MARKER);
+    entries.emplace_back(marker.FileExists() ? marker.GetModificationTime() : wxDateTime((time_t)0), marker.GetPath());
+  }
+  if (entries.size() <= FIRMWARECACHE_MAXENTRIES) return;
+
+  std::sort(entries.begin(), entries.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+  for (size_t idx = 0; idx < entries.size() - FIRMWARECACHE_MAXENTRIES; idx++) {
+    wxFileName::Rmdir(entries[idx].second, wxPATH_RMDIR_RECURSIVE);
+  }
+}
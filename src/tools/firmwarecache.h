@@ -0,0 +1,33 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include "tools/sketchoverlay.h"
+
+#include <mutex>
+#include <string>
+
+class EditorWindow;
+class Hash;
+
+// Compiled firmware, stored by a hash of everything that goes into it, so a config that has
+// already been built for a board doesn't need to be compiled again to verify or upload it.
+class FirmwareCache {
+public:
+  // Must be called after the config has been written out, since its bytes are part of the key.
+  static std::string getKey(EditorWindow*);
+  static std::string getKey(const std::string& config, const std::string& fqbn, const std::string& boardOptions, SketchOverlay::ConfigSelect);
+  // Directory with the cached ProffieOS.ino.* artifacts for `key`, or empty if there isn't one.
+  static std::string find(const std::string& key);
+  static bool store(const std::string& key, const std::string& buildPath);
+
+private:
+  FirmwareCache();
+  FirmwareCache(const FirmwareCache&) = delete;
+
+  static void fingerprintTree(Hash&, const std::string& root, const std::string& relative);
+  static void evict();
+
+  static std::mutex lock;
+};
@@ -0,0 +1,463 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "tools/flashstation.h"
+
+#include "core/defines.h"
+#include "core/appstate.h"
+#include "core/config/configuration.h"
+#include "core/utilities/threadrunner.h"
+#include "editor/editorwindow.h"
+#include "tools/arduino.h"
+#include "tools/builddirs.h"
+#include "tools/firmwarecache.h"
+
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#ifdef __WXMSW__
+#undef wxMessageDialog
+#include <wx/msgdlg.h>
+#define wxMessageDialog wxGenericMessageDialog
+#else
+#include <wx/msgdlg.h>
+#endif
+#include <wx/sizer.h>
+#include <wx/statbox.h>
+
+// Boards that were just unplugged or are still rebooting usually come around after a moment
+#define RETRY_DELAY std::chrono::seconds(3)
+
+FlashStation* FlashStation::instance{nullptr};
+wxEventTypeTag<wxCommandEvent> FlashStation::EVT_JOBUPDATE(wxNewEventType());
+
+FlashStation::FlashStation(MainMenu* parent) : wxFrame(parent, wxID_ANY, "Flashing Station") {
+  instance = this;
+
+  loadAssignments();
+  createUI();
+  bindEvents();
+  BoardWatch::addListener(this);
+  BoardWatch::start();
+  updateBoards();
+
+# ifdef __WXMSW__
+  SetIcon( wxICON(IDI_ICON1) );
+  SetBackgroundColour(wxSystemSettings::GetColour(wxSYS_COLOUR_FRAMEBK));
+# endif
+  Show(true);
+}
+FlashStation::~FlashStation() {
+  BoardWatch::removeListener(this);
+  instance = nullptr;
+}
+
+void FlashStation::createUI() {
+  auto sizer = new wxBoxSizer(wxVERTICAL);
+
+  boardList = new wxListCtrl(this, wxID_ANY, wxDefaultPosition, wxSize(700, 250), wxLC_REPORT);
+  boardList->AppendColumn("Board", wxLIST_FORMAT_LEFT, 140);
+  boardList->AppendColumn("Serial Number", wxLIST_FORMAT_LEFT, 150);
+  boardList->AppendColumn("Config", wxLIST_FORMAT_LEFT, 130);
+  boardList->AppendColumn("Status", wxLIST_FORMAT_LEFT, 210);
+  boardList->AppendColumn("Time", wxLIST_FORMAT_RIGHT, 60);
+
+  auto assignment = new wxBoxSizer(wxHORIZONTAL);
+  configSelect = new wxChoice(this, wxID_ANY);
+  configSelect->Append("No Config");
+  for (const auto& config : AppState::instance->getConfigFileNames()) configSelect->Append(config);
+  configSelect->SetSelection(0);
+  assignButton = new wxButton(this, ID_Assign, "Assign to Selected");
+  refreshButton = new wxButton(this, ID_Refresh, "Refresh Boards");
+  assignment->Add(configSelect, wxSizerFlags(0).Border(wxALL, 5));
+  assignment->Add(assignButton, wxSizerFlags(0).Border(wxALL, 5));
+  assignment->AddStretchSpacer();
+  assignment->Add(refreshButton, wxSizerFlags(0).Border(wxALL, 5));
+
+  auto controls = new wxBoxSizer(wxHORIZONTAL);
+  startButton = new wxButton(this, ID_Start, "Flash All");
+  retries = new wxSpinCtrl(this, wxID_ANY, "", wxDefaultPosition, wxDefaultSize, wxSP_ARROW_KEYS, 0, 5, 2);
+  status = new wxStaticText(this, wxID_ANY, "");
+  controls->Add(startButton, wxSizerFlags(0).Border(wxALL, 5));
+  controls->Add(new wxStaticText(this, wxID_ANY, "Retries"), wxSizerFlags(0).Border(wxLEFT | wxTOP | wxBOTTOM, 5).Center());
+  controls->Add(retries, wxSizerFlags(0).Border(wxALL, 5));
+  controls->Add(status, wxSizerFlags(1).Border(wxALL, 5).Center());
+
+  sizer->Add(boardList, wxSizerFlags(1).Border(wxALL, 10).Expand());
+  sizer->Add(assignment, wxSizerFlags(0).Border(wxLEFT | wxRIGHT, 5).Expand());
+  sizer->Add(controls, wxSizerFlags(0).Border(wxLEFT | wxRIGHT, 5).Expand());
+  sizer->Add(new wxStaticText(this, wxID_ANY, "Configs are compiled all at once, but boards are uploaded to one at a time, as their bootloaders can't be told apart."), wxSizerFlags(0).Border(wxLEFT | wxRIGHT | wxBOTTOM, 10));
+
+  SetSizerAndFit(sizer);
+}
+
+void FlashStation::bindEvents() {
+  Bind(wxEVT_CLOSE_WINDOW, [&](wxCloseEvent& event) {
+    if (running && event.CanVeto()) {
+      wxMessageDialog(this, "Please wait for the boards to finish flashing.", "Flashing In Progress", wxOK | wxICON_INFORMATION).ShowModal();
+      event.Veto();
+      return;
+    }
+    event.Skip();
+  });
+  Bind(BoardWatch::EVT_CHANGED, [&](wxCommandEvent&) { if (!running) updateBoards(); });
+  Bind(wxEVT_BUTTON, [&](wxCommandEvent&) { updateBoards(); }, ID_Refresh);
+  Bind(wxEVT_BUTTON, [&](wxCommandEvent&) { assign(); }, ID_Assign);
+  Bind(wxEVT_BUTTON, [&](wxCommandEvent&) { start(); }, ID_Start);
+  Bind(EVT_JOBUPDATE, [&](wxCommandEvent& event) {
+    if (event.GetInt() < 0) finish();
+    else updateRow(event.GetInt());
+    updateStatus();
+  }, wxID_ANY);
+}
+
+std::string FlashStation::getKey(const BoardWatch::Port& port) {
+  return port.serialNumber.empty() ? "port:" + port.address : "serial:" + port.serialNumber;
+}
+
+BoardWatch::Port FlashStation::findPort(const std::string& key, const BoardWatch::Port& port, bool loneBootloader) {
+  std::vector<BoardWatch::Port> ports;
+  if (!BoardWatch::getPorts(ports)) return port;
+
+  const BoardWatch::Port* bootloader{nullptr};
+  int32_t bootloaders{0};
+  for (const auto& current : ports) {
+    if (getKey(current) == key) return current;
+    if (current.protocol == "dfu") {
+      bootloader = &current;
+      bootloaders++;
+    }
+  }
+  if (loneBootloader && bootloaders == 1) return *bootloader;
+  return port;
+}
+
+void FlashStation::loadAssignments() {
+  std::ifstream file(FLASHSTATION_PATH);
+  std::string line;
+  while (std::getline(file, line)) {
+    auto split = line.find('\t');
+    if (split == std::string::npos) continue;
+    assignments[line.substr(0, split)] = line.substr(split + 1);
+  }
+}
+void FlashStation::saveAssignments() {
+  std::ofstream file(FLASHSTATION_PATH ".tmp");
+  if (!file.is_open()) {
+    std::cerr << "Error creating temporary flashing station file." << std::endl;
+    return;
+  }
+  for (const auto& [ key, config ] : assignments) file << key << '\t' << config << std::endl;
+  file.close();
+
+  remove(FLASHSTATION_PATH);
+  if (rename(FLASHSTATION_PATH ".tmp", FLASHSTATION_PATH) != 0) {
+    std::cerr << "Error saving flashing station file." << std::endl;
+  }
+}
+
+void FlashStation::updateBoards() {
+  std::vector<BoardWatch::Port> ports;
+  if (!BoardWatch::getPorts(ports)) {
+    status->SetLabel("Looking for boards...");
+    return;
+  }
+
+  // Results from the last run are for the old list
+  {
+    std::lock_guard<std::mutex> guard(jobLock);
+    jobs.clear();
+  }
+  stations.clear();
+  boardList->DeleteAllItems();
+  for (const auto& port : ports) {
+    if (port.address.empty()) continue;
+    if (port.protocol != "dfu" && !(port.protocol == "serial" && port.proffieboard)) continue;
+
+    auto assignment = assignments.find(getKey(port));
+    stations.push_back({ port, assignment == assignments.end() ? std::string{} : assignment->second });
+
+    auto row = boardList->InsertItem(boardList->GetItemCount(), port.protocol == "dfu" ? "BOOTLOADER|" + port.address : port.address);
+    boardList->SetItem(row, 1, port.serialNumber.empty() ? wxString("-") : wxString(port.serialNumber));
+    updateRow(stations.size() - 1);
+  }
+  updateStatus();
+}
+
+void FlashStation::assign() {
+  auto config = configSelect->GetSelection() <= 0 ? std::string{} : configSelect->GetStringSelection().ToStdString();
+  for (long row = boardList->GetFirstSelected(); row != -1; row = boardList->GetNextSelected(row)) {
+    auto& station = stations[row];
+    station.config = config;
+    if (config.empty()) assignments.erase(getKey(station.port));
+    else assignments[getKey(station.port)] = config;
+    updateRow(row);
+  }
+  saveAssignments();
+  updateStatus();
+}
+
+void FlashStation::updateRow(size_t stationIdx) {
+  if (stationIdx >= stations.size()) return;
+  const auto& station = stations[stationIdx];
+  boardList->SetItem(stationIdx, 2, station.config.empty() ? wxString("-") : wxString(station.config));
+
+  Job job;
+  bool found{false};
+  Build::State buildState{Build::State::BUILDING};
+  {
+    std::lock_guard<std::mutex> guard(jobLock);
+    for (const auto& candidate : jobs) {
+      if (candidate.station != stationIdx) continue;
+      job = candidate;
+      found = true;
+      auto build = builds.find(station.config);
+      if (build != builds.end()) buildState = build->second.state;
+      break;
+    }
+  }
+
+  wxString state;
+  wxColour colour = wxSystemSettings::GetColour(wxSYS_COLOUR_LISTBOXTEXT);
+  if (!found) {
+    state = station.config.empty() ? "No config assigned" : "Ready";
+  } else switch (job.state) {
+    case Job::State::WAITING:
+      state = buildState == Build::State::BUILDING ? "Compiling config..." : "Waiting for its turn to upload...";
+      break;
+    case Job::State::UPLOADING:
+      state = job.attempts > 1 ? wxString::Format("Uploading (attempt %d)...", job.attempts) : wxString("Uploading...");
+      break;
+    case Job::State::RETRYING:
+      state = "Retrying: " + job.message;
+      break;
+    case Job::State::DONE:
+      state = "Done";
+      break;
+    case Job::State::FAILED:
+      state = "Failed: " + job.message;
+      colour = *wxRED;
+      break;
+  }
+  state.Replace("\n", " ");
+  boardList->SetItem(stationIdx, 3, state);
+  boardList->SetItem(stationIdx, 4, found && (job.state == Job::State::DONE || job.state == Job::State::FAILED) ? wxString::Format("%.0fs", job.seconds) : wxString(""));
+  boardList->SetItemTextColour(stationIdx, colour);
+}
+
+void FlashStation::updateStatus() {
+  if (!running && jobs.empty()) {
+    int32_t assigned{0};
+    for (const auto& station : stations) if (!station.config.empty()) assigned++;
+    status->SetLabel(wxString::Format("%d boards found, %d with a config.", static_cast<int32_t>(stations.size()), assigned));
+    return;
+  }
+
+  int32_t done{0}, failed{0};
+  {
+    std::lock_guard<std::mutex> guard(jobLock);
+    for (const auto& job : jobs) {
+      if (job.state == Job::State::DONE) done++;
+      else if (job.state == Job::State::FAILED) failed++;
+    }
+  }
+  auto hours = std::chrono::duration<double>((running ? std::chrono::steady_clock::now() : endTime) - startTime).count() / 3600;
+  wxString summary = wxString::Format("%d of %d flashed", done, static_cast<int32_t>(jobs.size()));
+  if (failed) summary += wxString::Format(", %d failed", failed);
+  if (done && hours > 0) summary += wxString::Format(" (%.0f boards/hour)", done / hours);
+  status->SetLabel(summary + (running ? "..." : "."));
+}
+
+void FlashStation::start() {
+  if (running) return;
+
+  for (auto& [ config, build ] : builds) {
+    if (build.editor != nullptr) build.editor->Destroy();
+  }
+  builds.clear();
+  jobs.clear();
+  for (size_t idx = 0; idx < stations.size(); idx++) {
+    if (stations[idx].config.empty()) continue;
+
+    const auto& config = stations[idx].config;
+    if (builds.find(config) == builds.end()) {
+      auto& build = builds[config];
+      build.editor = new EditorWindow(".station-" + config, this);
+      if (!Configuration::readConfig(CONFIG_DIR + config + ".h", build.editor)) {
+        build.state = Build::State::FAILED;
+        build.message = "Could not read config";
+      }
+    }
+
+    Job job;
+    job.station = idx;
+    jobs.push_back(job);
+  }
+  if (jobs.empty()) {
+    wxMessageDialog(this, "Assign a config to at least one board.", "Nothing To Flash", wxOK | wxICON_INFORMATION).ShowModal();
+    return;
+  }
+
+  startButton->Disable();
+  assignButton->Disable();
+  refreshButton->Disable();
+  retries->Disable();
+  for (size_t idx = 0; idx < stations.size(); idx++) updateRow(idx);
+
+  running = true;
+  startTime = std::chrono::steady_clock::now();
+  auto maxRetries = retries->GetValue();
+  runningThreads = static_cast<int32_t>(builds.size() + jobs.size());
+  for (const auto& [ config, build ] : builds) {
+    auto name = config;
+    new ThreadRunner([this, name]() { runBuild(name); });
+  }
+  for (size_t idx = 0; idx < jobs.size(); idx++) new ThreadRunner([this, idx, maxRetries]() { runJob(idx, maxRetries); });
+  updateStatus();
+}
+
+void FlashStation::finish() {
+  for (auto& [ config, build ] : builds) {
+    remove((CONFIG_DIR + build.editor->getOpenConfig() + ".h").c_str());
+    build.editor->Destroy();
+    build.editor = nullptr;
+  }
+
+  running = false;
+  endTime = std::chrono::steady_clock::now();
+  startButton->Enable();
+  assignButton->Enable();
+  refreshButton->Enable();
+  retries->Enable();
+}
+
+void FlashStation::runBuild(const std::string& config) {
+  EditorWindow* editor;
+  {
+    std::lock_guard<std::mutex> guard(jobLock);
+    editor = builds[config].editor;
+    if (builds[config].state == Build::State::FAILED) editor = nullptr;
+  }
+
+  Build::State state{Build::State::FAILED};
+  std::string firmwareDir, message;
+  wxString returnVal;
+  if (editor == nullptr) {
+    message = "Could not read config";
+  } else if (!Configuration::outputConfig(editor)) {
+    message = "Config error";
+  } else {
+    auto cacheKey = FirmwareCache::getKey(editor);
+    firmwareDir = FirmwareCache::find(cacheKey);
+    if (firmwareDir.empty()) {
+      if (!Arduino::updateIno(returnVal, editor)) {
+        message = "Could not update ProffieOS file: " + returnVal.ToStdString();
+      } else if (!Arduino::compile(returnVal, editor, cacheKey)) {
+        message = returnVal.ToStdString();
+      } else {
+        firmwareDir = FirmwareCache::find(cacheKey);
+        // Not cached (the cache couldn't store it), so straight from where it was built
+        if (firmwareDir.empty()) firmwareDir = BuildDirs::acquire(editor->getOpenConfig(), Arduino::getFQBN(editor), Arduino::getBoardOptions(editor)).build;
+      }
+    }
+    if (message.empty()) state = Build::State::READY;
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(jobLock);
+    auto& build = builds[config];
+    build.state = state;
+    build.firmwareDir = firmwareDir;
+    build.message = message;
+  }
+  buildDone.notify_all();
+
+  std::vector<size_t> waiting;
+  {
+    std::lock_guard<std::mutex> guard(jobLock);
+    for (const auto& job : jobs) {
+      if (stations[job.station].config == config) waiting.push_back(job.station);
+    }
+  }
+  for (const auto station : waiting) postUpdate(station);
+  if (--runningThreads == 0) postUpdate(-1);
+}
+
+void FlashStation::runJob(size_t jobIdx, int32_t maxRetries) {
+  size_t station;
+  std::string config;
+  Build build;
+  {
+    std::unique_lock<std::mutex> guard(jobLock);
+    station = jobs[jobIdx].station;
+    config = stations[station].config;
+    buildDone.wait(guard, [&]() { return builds[config].state != Build::State::BUILDING; });
+    build = builds[config];
+  }
+  auto port = stations[station].port;
+  auto key = getKey(port);
+
+  auto setState = [&](Job::State state, const std::string& message = {}) {
+    {
+      std::lock_guard<std::mutex> guard(jobLock);
+      jobs[jobIdx].state = state;
+      jobs[jobIdx].message = message;
+      if (state == Job::State::UPLOADING) jobs[jobIdx].attempts++;
+    }
+    postUpdate(station);
+  };
+
+  auto startTime = std::chrono::steady_clock::now();
+  if (build.state == Build::State::FAILED) {
+    setState(Job::State::FAILED, "Compile failed: " + build.message);
+  } else {
+    setState(Job::State::WAITING);
+    for (int32_t attempt = 0; ; attempt++) {
+      {
+        // Taken again for each attempt, so other boards upload while this one waits to retry
+        std::lock_guard<std::mutex> uploadGuard(uploadLock);
+        if (attempt == 0) startTime = std::chrono::steady_clock::now();
+        else {
+          // Uploads are one at a time, so a lone bootloader is this board's, unless another one's been left in its
+          // bootloader by a failed upload too
+          bool othersFailed{false};
+          {
+            std::lock_guard<std::mutex> guard(jobLock);
+            for (size_t idx = 0; idx < jobs.size(); idx++) {
+              if (idx != jobIdx && (jobs[idx].state == Job::State::RETRYING || (jobs[idx].state == Job::State::FAILED && jobs[idx].attempts > 0))) othersFailed = true;
+            }
+          }
+          // The last attempt most likely left it in its bootloader, with a different port
+          port = findPort(key, port, !othersFailed);
+        }
+        setState(Job::State::UPLOADING);
+        wxString returnVal;
+        if (Arduino::upload(returnVal, build.editor, build.firmwareDir, nullptr, port)) {
+          setState(Job::State::DONE);
+          break;
+        }
+        // Before letting go, so the next upload knows this board may be sitting in its bootloader
+        if (attempt >= maxRetries) {
+          setState(Job::State::FAILED, returnVal.ToStdString());
+          break;
+        }
+        setState(Job::State::RETRYING, returnVal.ToStdString());
+      }
+      std::this_thread::sleep_for(RETRY_DELAY);
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(jobLock);
+    jobs[jobIdx].seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+  }
+  postUpdate(station);
+  if (--runningThreads == 0) postUpdate(-1);
+}
+
+void FlashStation::postUpdate(int32_t station) {
+  auto event = new wxCommandEvent(EVT_JOBUPDATE, wxID_ANY);
+  event->SetInt(station);
+  wxQueueEvent(GetEventHandler(), event);
+}
@@ -0,0 +1,121 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include "mainmenu/mainmenu.h"
+#include "tools/boardwatch.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <wx/button.h>
+#include <wx/choice.h>
+#include <wx/frame.h>
+#include <wx/listctrl.h>
+#include <wx/spinctrl.h>
+#include <wx/stattext.h>
+
+// Flashes many connected boards at once, each with the config it's been assigned. Assignments are kept
+// by the board's serial number (or its port, if it has none) so a board gets the same config next time.
+// Each config is compiled once, all at the same time. Uploads are done one board at a time, as the upload tool
+// would take whichever bootloader it finds; a board waiting to retry lets the others go ahead meanwhile.
+//
+// Uploads go through the Toolchain, so the whole thing can be run against a FakeToolchain script, which
+// can also supply the boards with `board list --watch` output and make uploads fail to exercise retries.
+class FlashStation : public wxFrame {
+public:
+  FlashStation(MainMenu*);
+  ~FlashStation();
+  static FlashStation* instance;
+
+private:
+  struct Station {
+    BoardWatch::Port port{};
+    std::string config{};
+  };
+  struct Build {
+    enum class State {
+      BUILDING,
+      READY,
+      FAILED
+    } state{State::BUILDING};
+    // Hidden, with the config loaded; shared by every upload of this config
+    EditorWindow* editor{nullptr};
+    std::string firmwareDir{};
+    std::string message{};
+  };
+  struct Job {
+    enum class State {
+      WAITING,
+      UPLOADING,
+      RETRYING,
+      DONE,
+      FAILED
+    } state{State::WAITING};
+    size_t station{0};
+    int32_t attempts{0};
+    std::string message{};
+    double seconds{0};
+  };
+
+  static wxEventTypeTag<wxCommandEvent> EVT_JOBUPDATE;
+
+  enum {
+    ID_Assign,
+    ID_Refresh,
+    ID_Start,
+  };
+
+  wxListCtrl* boardList{nullptr};
+  wxChoice* configSelect{nullptr};
+  wxButton* assignButton{nullptr};
+  wxButton* refreshButton{nullptr};
+  wxSpinCtrl* retries{nullptr};
+  wxButton* startButton{nullptr};
+  wxStaticText* status{nullptr};
+
+  std::vector<Station> stations{};
+  // Config for each board key, as saved
+  std::map<std::string, std::string> assignments{};
+
+  std::mutex jobLock{};
+  std::condition_variable buildDone{};
+  std::map<std::string, Build> builds{};
+  std::vector<Job> jobs{};
+  // Held through each upload attempt, not the wait before a retry
+  std::mutex uploadLock{};
+  std::atomic<int32_t> runningThreads{0};
+  // Only cleared once the last thread's final event has been handled, so the window outlives every thread
+  bool running{false};
+  std::chrono::steady_clock::time_point startTime{};
+  std::chrono::steady_clock::time_point endTime{};
+
+  void createUI();
+  void bindEvents();
+
+  // Serial number if there is one, the port otherwise
+  static std::string getKey(const BoardWatch::Port&);
+  // Where the board with `key` is now, which after a failed upload may be its bootloader; `port` if it can't be found.
+  // A bootloader without the serial number is only taken for it with `loneBootloader`, if it's the only one.
+  static BoardWatch::Port findPort(const std::string& key, const BoardWatch::Port& port, bool loneBootloader);
+  void loadAssignments();
+  void saveAssignments();
+
+  void updateBoards();
+  void updateRow(size_t station);
+  void updateStatus();
+  void assign();
+
+  void start();
+  void finish();
+  void runBuild(const std::string& config);
+  void runJob(size_t job, int32_t maxRetries);
+  void postUpdate(int32_t station);
+};
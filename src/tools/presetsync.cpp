@@ -0,0 +1,237 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "tools/presetsync.h"
+
+#include "core/defines.h"
+
+#include <cstdlib>
+#include <locale>
+#include <sstream>
+
+// Anything ProffieOS won't ever know, followed by a number
+#define FENCE_PREFIX "pc_sync_"
+
+static bool endsWith(const std::string& text, const std::string& end) {
+  return text.size() >= end.size() && text.compare(text.size() - end.size(), end.size(), end) == 0;
+}
+
+// Commands are a line each, so a value can't break one up
+static std::string oneLine(std::string value) {
+  for (auto& chr : value) if (chr == '\n' || chr == '\r') chr = ' ';
+  return value;
+}
+
+static std::string unescape(const std::string& value) {
+  std::string result;
+  result.reserve(value.size());
+  for (size_t idx = 0; idx < value.size(); idx++) {
+    if (value[idx] != '\\' || idx + 1 == value.size()) {
+      result += value[idx];
+      continue;
+    }
+    switch (value[++idx]) {
+      case 'n': result += '\n'; break;
+      case 't': result += '\t'; break;
+      default: result += value[idx];
+    }
+  }
+  return result;
+}
+
+PresetSync::PresetSync(std::function<void(const std::string&)> send) : send(std::move(send)) {}
+
+void PresetSync::receive(const std::string& data) {
+  partialLine += data;
+  size_t start{0};
+  for (auto end = partialLine.find('\n'); end != std::string::npos; start = end + 1, end = partialLine.find('\n', start)) {
+    auto line = partialLine.substr(start, end - start);
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    handleLine(line);
+  }
+  partialLine.erase(0, start);
+}
+
+void PresetSync::handleLine(const std::string& line) {
+  if (pending.empty()) return;
+
+  auto& current = pending.front();
+  if (endsWith(line, current.fence)) {
+    lastProgress = std::chrono::steady_clock::now();
+    responses.push_back(std::move(current.response));
+    pending.pop_front();
+    if (pending.empty()) finish("");
+    return;
+  }
+  // Fences left over from something that failed earlier are nothing to worry about
+  if (line.rfind("Whut?", 0) == 0 && line.find(FENCE_PREFIX) == std::string::npos) {
+    auto command = current.response.command.substr(0, current.response.command.find(' '));
+    finish("The board does not know \"" + command + "\". Editing presets over serial needs an SD card and a ProffieOS with SAVE_PRESET.");
+    return;
+  }
+  current.response.lines.push_back(line);
+}
+
+void PresetSync::checkTimeout() {
+  if (pending.empty()) return;
+  if (std::chrono::steady_clock::now() - lastProgress < std::chrono::milliseconds(PRESETSYNC_TIMEOUT)) return;
+  finish("The board stopped answering during \"" + pending.front().response.command + "\".");
+}
+
+void PresetSync::run(const std::vector<std::string>& commands, std::function<void(const std::vector<Response>&, const std::string&)> callback) {
+  if (busy()) {
+    callback({}, "Still waiting on the board to finish the last change.");
+    return;
+  }
+  if (commands.empty()) {
+    callback({}, "");
+    return;
+  }
+
+  onFinish = std::move(callback);
+  lastProgress = std::chrono::steady_clock::now();
+  for (const auto& command : commands) {
+    pending.push_back({ { command }, FENCE_PREFIX + std::to_string(++fenceCount) });
+    send(command);
+    send(pending.back().fence);
+  }
+}
+
+void PresetSync::finish(const std::string& error) {
+  // Cleared first, the callback may well start something new
+  auto callback = std::move(onFinish);
+  auto done = std::move(responses);
+  onFinish = nullptr;
+  responses.clear();
+  pending.clear();
+
+  if (callback) callback(done, error);
+}
+
+void PresetSync::list(ListCallback callback) {
+  run({ "list_presets" }, [callback](const std::vector<Response>& responses, const std::string& error) {
+    if (!error.empty()) {
+      callback({}, error);
+      return;
+    }
+    auto presets = parseList(responses.front().lines);
+    if (presets.empty()) callback({}, "The board did not list any presets.");
+    else callback(presets, "");
+  });
+}
+
+void PresetSync::push(const std::vector<Preset>& board, const std::vector<Preset>& wanted, DoneCallback callback) {
+  if (board.empty()) {
+    callback("The board has no saved presets to start from.");
+    return;
+  }
+  if (wanted.empty()) {
+    callback("There are no presets to send, a board needs at least one.");
+    return;
+  }
+  run(diff(board, wanted), [callback](const std::vector<Response>&, const std::string& error) { callback(error); });
+}
+
+std::vector<std::string> PresetSync::diff(const std::vector<Preset>& board, const std::vector<Preset>& wanted) {
+  std::vector<std::string> commands;
+  if (board.empty()) return commands;
+
+  // New ones start out as a copy of the last and are changed from there
+  auto current = board;
+  while (current.size() > wanted.size()) {
+    commands.push_back("delete_preset " + std::to_string(current.size() - 1));
+    current.pop_back();
+  }
+  while (current.size() < wanted.size()) {
+    commands.push_back("duplicate_preset " + std::to_string(current.size() - 1));
+    current.push_back(current.back());
+  }
+
+  for (size_t preset = 0; preset < wanted.size(); preset++) {
+    const auto& from = current[preset];
+    const auto& to = wanted[preset];
+    auto number = std::to_string(preset);
+
+    if (from.font != to.font) commands.push_back("set_font " + number + " " + oneLine(to.font));
+    if (from.track != to.track) commands.push_back("set_track " + number + " " + oneLine(to.track));
+    for (size_t blade = 0; blade < to.styles.size(); blade++) {
+      if (blade < from.styles.size() && from.styles[blade] == to.styles[blade]) continue;
+      commands.push_back("set_style" + std::to_string(blade + 1) + " " + number + " " + oneLine(to.styles[blade]));
+    }
+    if (from.name != to.name) commands.push_back("set_name " + number + " " + oneLine(to.name));
+  }
+
+  return commands;
+}
+
+std::vector<PresetSync::Preset> PresetSync::parseList(const std::vector<std::string>& lines) {
+  std::vector<Preset> presets;
+  for (const auto& line : lines) {
+    auto separator = line.find('=');
+    if (separator == std::string::npos) continue;
+    auto key = line.substr(0, separator);
+    auto value = unescape(line.substr(separator + 1));
+
+    // Each preset's list starts with its font
+    if (key == "FONT") {
+      presets.emplace_back();
+      presets.back().font = value;
+      continue;
+    }
+    if (presets.empty()) continue;
+
+    auto& preset = presets.back();
+    if (key == "TRACK") preset.track = value;
+    else if (key == "NAME") preset.name = value;
+    else if (key.rfind("STYLE", 0) == 0) {
+      auto blade = std::atoi(key.c_str() + 5);
+      if (blade < 1) continue;
+      if (preset.styles.size() < static_cast<size_t>(blade)) preset.styles.resize(blade);
+      preset.styles[blade - 1] = value;
+    }
+  }
+  return presets;
+}
+
+std::string PresetSync::builtin(size_t preset, size_t blade, const std::string& args) {
+  auto style = "builtin " + std::to_string(preset) + " " + std::to_string(blade + 1);
+  if (!args.empty()) style += " " + args;
+  return style;
+}
+
+bool PresetSync::parseBuiltin(const std::string& style, size_t& preset, size_t& blade, std::string& args) {
+  std::istringstream stream(style);
+  stream.imbue(std::locale::classic());
+  std::string word;
+  int64_t presetNum{-1}, bladeNum{-1};
+  if (!(stream >> word) || word != "builtin" || !(stream >> presetNum >> bladeNum) || presetNum < 0 || bladeNum < 1) return false;
+
+  std::getline(stream, args);
+  args.erase(0, args.find_first_not_of(' '));
+  preset = presetNum;
+  blade = bladeNum - 1;
+  return true;
+}
+
+std::string PresetSync::getStyleArgs(const std::string& style) {
+  auto end = style.find_last_not_of(" \t\r\n;");
+  if (end == std::string::npos || end < 2 || style[end] != ')' || style[end - 1] != '"') return "";
+
+  auto start = style.rfind("(\"", end - 2);
+  if (start == std::string::npos) return "";
+  return style.substr(start + 2, end - 1 - (start + 2));
+}
+
+std::string PresetSync::setStyleArgs(const std::string& style, const std::string& args) {
+  auto end = style.find_last_not_of(" \t\r\n;");
+  if (end == std::string::npos || end < 1 || style[end] != ')') return style;
+
+  size_t start;
+  if (style[end - 1] == '(') start = end;
+  else if (style[end - 1] == '"' && (start = style.rfind("(\"", end - 2)) != std::string::npos) start++;
+  else return style;
+
+  auto result = style.substr(0, start);
+  if (!args.empty()) result += "\"" + args + "\"";
+  return result + style.substr(end);
+}
@@ -0,0 +1,79 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Lists and changes the presets a board has saved to its SD card with ProffieOS's serial commands,
+// so names, fonts, tracks and style arguments can be changed in seconds instead of with a compile and upload.
+// The styles themselves are compiled in; saved presets use them as "builtin <preset> <blade>", followed by any arguments.
+//
+// Each command is followed by one ProffieOS won't know, and the "Whut?" that comes back marks the end of the answer,
+// so everything can be sent at once. It only deals in lines of text, whatever carries them.
+class PresetSync {
+public:
+  struct Preset {
+    std::string name{};
+    std::string font{};
+    std::string track{};
+    // STYLE1 and on, one per blade
+    std::vector<std::string> styles{};
+  };
+  struct Response {
+    std::string command{};
+    std::vector<std::string> lines{};
+  };
+
+  // Empty `error` on success
+  using ListCallback = std::function<void(const std::vector<Preset>&, const std::string& error)>;
+  using DoneCallback = std::function<void(const std::string& error)>;
+
+  PresetSync(std::function<void(const std::string&)> send);
+  PresetSync(const PresetSync&) = delete;
+
+  // Whatever the board sent, in pieces of any size
+  void receive(const std::string&);
+  // Fails what's outstanding once the board's stopped answering, to be called periodically
+  void checkTimeout();
+  bool busy() const { return !pending.empty(); }
+
+  void list(ListCallback);
+  // Changes the board's presets from `board`, as just listed, to `wanted`
+  void push(const std::vector<Preset>& board, const std::vector<Preset>& wanted, DoneCallback);
+
+  // The commands to get from one list to the other, only for what differs
+  static std::vector<std::string> diff(const std::vector<Preset>& board, const std::vector<Preset>& wanted);
+  // Lines of list_presets output, anything else among them is skipped
+  static std::vector<Preset> parseList(const std::vector<std::string>& lines);
+
+  static std::string builtin(size_t preset, size_t blade, const std::string& args);
+  // False if `style` isn't a builtin one
+  static bool parseBuiltin(const std::string& style, size_t& preset, size_t& blade, std::string& args);
+  // The argument string a style's code is given, as in StylePtr<...>("args")
+  static std::string getStyleArgs(const std::string& style);
+  static std::string setStyleArgs(const std::string& style, const std::string& args);
+
+private:
+  struct Pending {
+    Response response{};
+    std::string fence{};
+  };
+
+  void run(const std::vector<std::string>& commands, std::function<void(const std::vector<Response>&, const std::string& error)>);
+  void finish(const std::string& error);
+  void handleLine(const std::string&);
+
+  std::function<void(const std::string&)> send;
+  std::deque<Pending> pending{};
+  std::vector<Response> responses{};
+  std::function<void(const std::vector<Response>&, const std::string&)> onFinish{};
+  std::string partialLine{};
+  uint32_t fenceCount{0};
+  std::chrono::steady_clock::time_point lastProgress{};
+};
@@ -0,0 +1,216 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "tools/process.h"
+
+#include <iostream>
+
+#ifndef __WXMSW__
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifndef __linux__
+#include <mutex>
+#endif
+
+extern char** environ;
+#endif
+
+Process::~Process() {
+  kill();
+  finish();
+}
+
+#ifdef __WXMSW__
+
+bool Process::start(const std::vector<std::string>& args, bool) {
+  std::string command = R"(title ProffieConfig Worker & resources\windowmode -title "ProffieConfig Worker" -mode force_minimized & )";
+  for (const auto& arg : args) command += "\"" + arg + "\" ";
+  command += "2>&1";
+
+  pipe = popen(command.c_str(), "r");
+  return pipe != nullptr;
+}
+
+bool Process::readLine(Line& line) {
+  if (pipe == nullptr) return false;
+
+  char buffer[1024];
+  line = { Stream::STDOUT, {} };
+  while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
+    line.text += buffer;
+    if (line.text.back() != '\n') continue;
+
+    line.text.pop_back();
+    if (!line.text.empty() && line.text.back() == '\r') line.text.pop_back();
+    return true;
+  }
+  return !line.text.empty();
+}
+
+int32_t Process::finish() {
+  if (pipe == nullptr) return -1;
+  auto result = pclose(pipe);
+  pipe = nullptr;
+  return result;
+}
+
+void Process::kill() {
+  // The process belongs to the shell, there's nothing reliable to signal
+}
+
+#else
+
+#ifndef __linux__
+// Without pipe2() a pipe is briefly inheritable, so no other spawn may happen until it's marked close-on-exec
+static std::mutex spawnLock;
+#endif
+
+// Close-on-exec from the start, so children started on other threads don't hold the write ends open.
+// The dup2 in the file actions gives this child its own copies regardless.
+static bool makePipe(int32_t fds[2]) {
+# ifdef __linux__
+  return pipe2(fds, O_CLOEXEC) == 0;
+# else
+  if (pipe(fds) != 0) return false;
+  fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+  fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+  return true;
+# endif
+}
+
+bool Process::start(const std::vector<std::string>& args, bool lowPriority) {
+  if (args.empty()) return false;
+
+# ifndef __linux__
+  std::lock_guard<std::mutex> lock(spawnLock);
+# endif
+  int32_t outPipe[2], errPipe[2];
+  if (!makePipe(outPipe)) return false;
+  if (!makePipe(errPipe)) {
+    close(outPipe[0]);
+    close(outPipe[1]);
+    return false;
+  }
+
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_addclose(&actions, outPipe[0]);
+  posix_spawn_file_actions_addclose(&actions, errPipe[0]);
+  posix_spawn_file_actions_adddup2(&actions, outPipe[1], STDOUT_FILENO);
+  posix_spawn_file_actions_adddup2(&actions, errPipe[1], STDERR_FILENO);
+  posix_spawn_file_actions_addclose(&actions, outPipe[1]);
+  posix_spawn_file_actions_addclose(&actions, errPipe[1]);
+
+  // Own process group, so kill() also gets the compilers arduino-cli starts
+  posix_spawnattr_t attributes;
+  posix_spawnattr_init(&attributes);
+  posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP);
+  posix_spawnattr_setpgroup(&attributes, 0);
+
+  std::vector<char*> argv;
+  for (const auto& arg : args) argv.push_back(const_cast<char*>(arg.c_str()));
+  argv.push_back(nullptr);
+
+  pid_t child;
+  auto result = posix_spawn(&child, argv[0], &actions, &attributes, argv.data(), environ);
+  posix_spawn_file_actions_destroy(&actions);
+  posix_spawnattr_destroy(&attributes);
+  close(outPipe[1]);
+  close(errPipe[1]);
+  if (result != 0) {
+    std::cerr << "Failed to start " << args[0] << ": " << std::strerror(result) << std::endl;
+    close(outPipe[0]);
+    close(errPipe[0]);
+    return false;
+  }
+  pid = child;
+  // The group is still just the child, which hasn't had a chance to start anything yet; what it does start inherits this
+  if (lowPriority) setpriority(PRIO_PGRP, child, 10);
+
+  outFd = outPipe[0];
+  errFd = errPipe[0];
+  fcntl(outFd, F_SETFL, fcntl(outFd, F_GETFL) | O_NONBLOCK);
+  fcntl(errFd, F_SETFL, fcntl(errFd, F_GETFL) | O_NONBLOCK);
+  return true;
+}
+
+bool Process::readLine(Line& line) {
+  while (pending.empty() && (outFd != -1 || errFd != -1)) {
+    pollfd fds[2]{ { outFd, POLLIN, 0 }, { errFd, POLLIN, 0 } };
+    if (poll(fds, 2, -1) < 0) {
+      if (errno == EINTR) continue;
+      break;
+    }
+
+    // Negative fds are ignored by poll, and their revents left 0
+    if (fds[0].revents) drain(outFd, outBuffer, Stream::STDOUT);
+    if (fds[1].revents) drain(errFd, errBuffer, Stream::STDERR);
+  }
+
+  if (pending.empty()) return false;
+  line = pending.front();
+  pending.pop_front();
+  return true;
+}
+
+bool Process::drain(int32_t& fd, std::string& buffer, Stream stream) {
+  char chunk[4096];
+  while (true) {
+    auto count = read(fd, chunk, sizeof(chunk));
+    if (count > 0) {
+      buffer.append(chunk, count);
+      continue;
+    }
+    if (count < 0 && errno == EINTR) continue;
+    if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+
+    // EOF or error, either way this stream is done
+    close(fd);
+    fd = -1;
+    break;
+  }
+
+  size_t start{0}, end;
+  while ((end = buffer.find('\n', start)) != std::string::npos) {
+    auto text = buffer.substr(start, end - start);
+    if (!text.empty() && text.back() == '\r') text.pop_back();
+    pending.push_back({ stream, text });
+    start = end + 1;
+  }
+  buffer.erase(0, start);
+
+  if (fd == -1 && !buffer.empty()) {
+    pending.push_back({ stream, buffer });
+    buffer.clear();
+  }
+  return fd != -1;
+}
+
+int32_t Process::finish() {
+  if (pid == -1) return exited ? exitCode : -1;
+
+  if (outFd != -1) close(outFd);
+  if (errFd != -1) close(errFd);
+  outFd = errFd = -1;
+
+  int32_t status{0};
+  while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+  pid = -1;
+  exited = true;
+  exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+  return exitCode;
+}
+
+void Process::kill() {
+  pid_t target = pid;
+  if (target > 0) ::kill(-target, SIGTERM);
+}
+
+#endif
@@ -0,0 +1,62 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <vector>
+
+#ifndef __WXMSW__
+#include <sys/types.h>
+#endif
+
+// A child process whose stdout and stderr are read separately, line by line, without one
+// stream's pipe filling up and stalling the child while we wait on the other.
+class Process {
+public:
+  enum class Stream {
+    STDOUT,
+    STDERR
+  };
+  struct Line {
+    Stream stream{Stream::STDOUT};
+    std::string text{};
+  };
+
+  Process() = default;
+  Process(const Process&) = delete;
+  ~Process();
+
+  // args[0] is the program. No shell is involved, so arguments need no quoting.
+  // lowPriority lowers the scheduling priority of the process and everything it starts (not on Windows).
+  bool start(const std::vector<std::string>& args, bool lowPriority = false);
+  // Blocks until a full line is available, false once the process has closed both streams.
+  bool readLine(Line&);
+  // Waits for exit, returns the exit code (or -1 if it was killed or couldn't be started)
+  int32_t finish();
+  // Safe to call from another thread while one is blocked in readLine()
+  void kill();
+
+private:
+  std::deque<Line> pending{};
+
+# ifdef __WXMSW__
+  // Windows builds go through the shell (for the console window workaround), with stderr merged into stdout.
+  FILE* pipe{nullptr};
+# else
+  std::atomic<pid_t> pid{-1};
+  int32_t outFd{-1};
+  int32_t errFd{-1};
+  std::string outBuffer{};
+  std::string errBuffer{};
+  int32_t exitCode{-1};
+  bool exited{false};
+
+  // Reads whatever is available on fd into buffer, queueing complete lines. False on EOF.
+  bool drain(int32_t& fd, std::string& buffer, Stream);
+# endif
+};
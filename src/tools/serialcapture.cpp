@@ -0,0 +1,268 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "tools/serialcapture.h"
+
+#include "core/defines.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <locale>
+#include <sstream>
+#include <wx/dir.h>
+#include <wx/filename.h>
+#include <wx/log.h>
+#include <wx/regex.h>
+
+#define INDEX_FILE "index"
+// How stale the index and the end of the current segment can be if ProffieConfig doesn't get to close the capture
+#define SYNC_INTERVAL std::chrono::seconds(1)
+
+static wxFileName getDir(const std::string& session) {
+  auto dir = wxFileName::DirName(SERIALCAPTURE_PATH);
+  dir.AppendDir(session);
+  return dir;
+}
+
+SerialCapture::~SerialCapture() {
+  if (stream) closeSegment();
+}
+
+bool SerialCapture::open(std::string& error) {
+  auto sessions = getSessions();
+  // Making room for the one about to be started
+  for (size_t idx = SERIALCAPTURE_SESSIONS - 1; idx < sessions.size(); idx++) {
+    if (!wxFileName::Rmdir(getDir(sessions[idx]).GetPath(), wxPATH_RMDIR_RECURSIVE)) std::cerr << "Failed to remove old serial capture " << sessions[idx] << std::endl;
+  }
+
+  auto name = formatTime(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count()).substr(0, 19);
+  std::replace(name.begin(), name.end(), ' ', '_');
+  std::replace(name.begin(), name.end(), ':', '-');
+  session = name;
+  for (int32_t idx = 2; getDir(session).DirExists(); idx++) session = name + "-" + std::to_string(idx);
+
+  if (!getDir(session).Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL)) {
+    error = "Could not create the capture directory.";
+    return false;
+  }
+  if (!openSegment()) {
+    error = "Could not create the capture file.";
+    return false;
+  }
+  return true;
+}
+
+bool SerialCapture::write(const char* data, size_t size) {
+  if (!stream) return false;
+
+  auto now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  // Everything read at once arrived at once, so it all gets the same stamp.
+  // Not local time, which repeats an hour when the clocks go back.
+  auto stamp = std::to_string(now) + ' ';
+  std::string output;
+  output.reserve(size + stamp.size() * 4);
+  for (size_t idx = 0; idx < size; idx++) {
+    if (data[idx] == '\r') continue;
+    if (lineStart) {
+      auto& segment = segments.back();
+      segment.first = segment.lines == 0 ? now : std::min(segment.first, now);
+      segment.last = segment.lines == 0 ? now : std::max(segment.last, now);
+      segment.lines++;
+      output += stamp;
+      lineStart = false;
+    }
+    output += data[idx];
+    if (data[idx] == '\n') lineStart = true;
+  }
+
+  stream->Write(output.data(), output.size());
+  if (!stream->IsOk()) return false;
+  segmentSize += output.size();
+
+  if (segmentSize >= SERIALCAPTURE_SEGMENT) {
+    // Lines are never split between segments, each one must start with its stamp
+    if (!lineStart) {
+      stream->Write("\n", 1);
+      lineStart = true;
+    }
+    closeSegment();
+    return openSegment();
+  }
+
+  auto syncTime = std::chrono::steady_clock::now();
+  if (syncTime - lastSync >= SYNC_INTERVAL) {
+    stream->Sync();
+    saveIndex();
+    lastSync = syncTime;
+  }
+  return stream->IsOk();
+}
+
+bool SerialCapture::openSegment() {
+  char name[32];
+  std::snprintf(name, sizeof(name), "%04zu.log.gz", segments.size());
+
+  file = std::make_unique<wxFileOutputStream>(wxFileName(getDir(session).GetPath(), name).GetFullPath());
+  if (!file->IsOk()) {
+    file.reset();
+    return false;
+  }
+  // Fastest, it's the reading thread doing the compressing
+  stream = std::make_unique<wxZlibOutputStream>(*file, wxZ_BEST_SPEED, wxZLIB_GZIP);
+
+  segments.push_back({ name });
+  segmentSize = 0;
+  lineStart = true;
+  saveIndex();
+  lastSync = std::chrono::steady_clock::now();
+  return true;
+}
+
+void SerialCapture::closeSegment() {
+  stream->Close();
+  stream.reset();
+  file->Close();
+  file.reset();
+  saveIndex();
+}
+
+void SerialCapture::saveIndex() {
+  auto path = wxFileName(getDir(session).GetPath(), INDEX_FILE).GetFullPath().ToStdString();
+  std::ofstream indexFile(path + ".tmp");
+  if (!indexFile.is_open()) {
+    std::cerr << "Failed to save serial capture index." << std::endl;
+    return;
+  }
+  indexFile.imbue(std::locale::classic());
+  for (const auto& segment : segments) {
+    indexFile << segment.file << '\t' << segment.first << '\t' << segment.last << '\t' << segment.lines << std::endl;
+  }
+  indexFile.close();
+
+  if (rename((path + ".tmp").c_str(), path.c_str()) != 0) {
+    remove(path.c_str());
+    if (rename((path + ".tmp").c_str(), path.c_str()) != 0) std::cerr << "Failed to save serial capture index." << std::endl;
+  }
+}
+
+std::vector<std::string> SerialCapture::getSessions() {
+  std::vector<std::string> sessions;
+  wxDir capturesDir(SERIALCAPTURE_PATH);
+  if (!capturesDir.IsOpened()) return sessions;
+
+  wxString name;
+  for (bool found = capturesDir.GetFirst(&name, wxEmptyString, wxDIR_DIRS); found; found = capturesDir.GetNext(&name)) {
+    sessions.push_back(name.ToStdString());
+  }
+  // Named by when they started
+  std::sort(sessions.rbegin(), sessions.rend());
+  return sessions;
+}
+
+std::vector<SerialCapture::Segment> SerialCapture::loadIndex(const std::string& session) {
+  std::vector<Segment> segments;
+  std::ifstream indexFile(wxFileName(getDir(session).GetPath(), INDEX_FILE).GetFullPath().ToStdString());
+  indexFile.imbue(std::locale::classic());
+
+  std::string line;
+  while (std::getline(indexFile, line)) {
+    std::istringstream fields(line);
+    fields.imbue(std::locale::classic());
+    Segment segment;
+    if (std::getline(fields, segment.file, '\t') && fields >> segment.first >> segment.last >> segment.lines) segments.push_back(segment);
+  }
+  return segments;
+}
+
+bool SerialCapture::search(const std::string& session, int64_t from, int64_t to, const std::string& pattern, size_t limit, std::vector<Line>& results, std::string& error) {
+  // Not std::regex, which recurses once per character and so overflows the stack on a long enough line
+  wxRegEx regex;
+  if (!pattern.empty()) {
+    // Reported in the search window, not as a log popup
+    wxLogNull noLog;
+    if (!regex.Compile(wxString::FromUTF8(pattern), wxRE_ADVANCED)) {
+      error = "The search is not a valid regular expression.";
+      return false;
+    }
+  }
+
+  // Lines aren't necessarily in time order, the clock can be set back, so every one in a segment is checked.
+  // False once there are enough.
+  auto handleLine = [&](const std::string& line) {
+    int64_t time{0};
+    size_t pos{0};
+    for (; pos < line.size() && pos < 18 && std::isdigit(static_cast<unsigned char>(line[pos])); pos++) time = time * 10 + (line[pos] - '0');
+    if (pos == 0 || pos >= line.size() || line[pos] != ' ') return true;
+    if (time < from || time > to) return true;
+
+    auto text = line.substr(pos + 1);
+    if (!pattern.empty()) {
+      auto wxText = wxString::FromUTF8(text);
+      // Whatever the board sent isn't necessarily UTF-8
+      if (wxText.empty() && !text.empty()) wxText = wxString::From8BitData(text.data(), text.size());
+      if (!regex.Matches(wxText)) return true;
+    }
+    results.push_back({ time, text });
+    return results.size() < limit;
+  };
+
+  char buffer[64 * 1024];
+  for (const auto& segment : loadIndex(session)) {
+    if (segment.lines == 0 || segment.last < from || segment.first > to) continue;
+
+    wxFileInputStream file(wxFileName(getDir(session).GetPath(), segment.file).GetFullPath());
+    if (!file.IsOk()) continue;
+    wxZlibInputStream stream(file, wxZLIB_GZIP);
+
+    // A segment cut off by a crash is read as far as it goes
+    std::string pending;
+    while (true) {
+      stream.Read(buffer, sizeof(buffer));
+      auto count = stream.LastRead();
+      if (count == 0) break;
+      pending.append(buffer, count);
+
+      size_t start{0};
+      for (auto end = pending.find('\n'); end != std::string::npos; start = end + 1, end = pending.find('\n', start)) {
+        if (!handleLine(pending.substr(start, end - start))) return true;
+      }
+      pending.erase(0, start);
+    }
+    if (!pending.empty() && !handleLine(pending)) return true;
+  }
+
+  return true;
+}
+
+std::string SerialCapture::formatTime(int64_t time) {
+  auto seconds = static_cast<time_t>(time / 1000);
+  tm local{};
+# ifdef __WXMSW__
+  localtime_s(&local, &seconds);
+# else
+  localtime_r(&seconds, &local);
+# endif
+
+  char text[64];
+  std::snprintf(text, sizeof(text), "%04d-%02d-%02d %02d:%02d:%02d.%03d", local.tm_year + 1900, local.tm_mon + 1, local.tm_mday, local.tm_hour, local.tm_min, local.tm_sec, static_cast<int32_t>(time % 1000));
+  return text;
+}
+
+bool SerialCapture::parseTime(const std::string& text, int64_t& time) {
+  tm local{};
+  int32_t milliseconds{0};
+  if (std::sscanf(text.c_str(), "%d-%d-%d %d:%d:%d.%3d", &local.tm_year, &local.tm_mon, &local.tm_mday, &local.tm_hour, &local.tm_min, &local.tm_sec, &milliseconds) < 6) return false;
+
+  local.tm_year -= 1900;
+  local.tm_mon -= 1;
+  local.tm_isdst = -1;
+  auto seconds = mktime(&local);
+  if (seconds == -1) return false;
+
+  time = static_cast<int64_t>(seconds) * 1000 + milliseconds;
+  return true;
+}
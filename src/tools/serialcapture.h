@@ -0,0 +1,69 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <wx/wfstream.h>
+#include <wx/zstream.h>
+
+// Writes everything a board sends to disk, each line stamped with when it arrived (ms since the epoch), for captures
+// far longer than the serial monitor keeps. Each capture is a session directory of gzipped segments,
+// a new one started every SERIALCAPTURE_SEGMENT bytes, plus an index of the time each segment covers.
+// The index is all that's read to list or narrow down a capture, so a search only opens the segments it needs.
+//
+// A capture is written by one thread only, the one reading the port.
+class SerialCapture {
+public:
+  struct Segment {
+    std::string file{};
+    // ms since the epoch, of the earliest and latest line in it; the clock can be set back during a capture
+    int64_t first{0};
+    int64_t last{0};
+    uint64_t lines{0};
+  };
+  struct Line {
+    int64_t time{0};
+    std::string text{};
+  };
+
+  SerialCapture() = default;
+  SerialCapture(const SerialCapture&) = delete;
+  // Finishes the current segment and index
+  ~SerialCapture();
+
+  // Starts a new session, dropping the oldest ones past SERIALCAPTURE_SESSIONS
+  bool open(std::string& error);
+  // False if writing failed, after which the capture should be closed
+  bool write(const char* data, size_t size);
+  const std::string& getSession() const { return session; }
+
+  // Newest first
+  static std::vector<std::string> getSessions();
+  static std::vector<Segment> loadIndex(const std::string& session);
+  // Lines from `from` to `to` (ms since the epoch) that match `pattern`, a UTF-8 regular expression (any line if empty),
+  // up to `limit` of them
+  static bool search(const std::string& session, int64_t from, int64_t to, const std::string& pattern, size_t limit, std::vector<Line>& results, std::string& error);
+
+  // Local time, "YYYY-MM-DD HH:MM:SS.mmm", as lines are shown with
+  static std::string formatTime(int64_t);
+  // Takes the same format, with or without the milliseconds
+  static bool parseTime(const std::string&, int64_t&);
+
+private:
+  bool openSegment();
+  void closeSegment();
+  void saveIndex();
+
+  std::string session{};
+  std::vector<Segment> segments{};
+  std::unique_ptr<wxFileOutputStream> file{};
+  std::unique_ptr<wxZlibOutputStream> stream{};
+  uint64_t segmentSize{0};
+  bool lineStart{true};
+  std::chrono::steady_clock::time_point lastSync{};
+};
@@ -4,7 +4,9 @@
 #include "tools/serialmonitor.h"
 
 #include "core/defines.h"
+#include "core/appstate.h"
 #include "mainmenu/mainmenu.h"
+#include "tools/capturesearch.h"
 
 #ifdef __WXMSW__
 #include <windows.h>
@@ -25,41 +27,59 @@ SerialMonitor::SerialMonitor(MainMenu* parent) {
 
 #elif defined(__WXOSX__) || defined(__WXGTK__)
 
+#include <algorithm>
+#include <cerrno>
+#include <iostream>
 #include <fcntl.h>
+#include <poll.h>
 #include <stdio.h>
-#include <sys/stat.h>
 #include <sys/types.h>
 #include <termios.h>
+#include <unistd.h>
 
-SerialMonitor::SerialMonitor(MainMenu* parent) : wxFrame(parent, wxID_ANY, "Proffie Serial")
+SerialMonitor::SerialMonitor(MainMenu* parent) : wxFrame(parent, wxID_ANY, "Proffie Serial"), received(SERIALMONITOR_BUFFER), writer(SERIALMONITOR_COMMANDS), presetSync([this](const std::string& command) { send(command); })
 {
   instance = this;
 
   wxBoxSizer *master = new wxBoxSizer(wxVERTICAL);
 
   input = new pcTextCtrl(this, ID_SerialCommand, wxEmptyString, wxDefaultPosition, wxDefaultSize, wxTE_PROCESS_ENTER);
-  output = new pcTextCtrl(this, wxID_ANY, wxEmptyString, wxDefaultPosition, wxSize(500, 200), wxTE_MULTILINE | wxTE_READONLY);
+  output = new LogView(this, AppState::instance->serialScrollback);
+  scrollback = new pcSpinCtrl(this, ID_Scrollback, "Scrollback Lines", wxDefaultPosition, wxDefaultSize, wxSP_ARROW_KEYS, 100, 1000000, AppState::instance->serialScrollback, wxHORIZONTAL);
+  frameTimer = new wxTimer(this, ID_FrameTimer);
+  syncTimer = new wxTimer(this, ID_SyncTimer);
+  captureCheck = new wxCheckBox(this, ID_Capture, "Capture to Disk");
+  captureStatus = new wxStaticText(this, wxID_ANY, wxEmptyString);
+  searchButton = new wxButton(this, ID_SearchCaptures, "Search Captures...");
+
+  auto options = new wxBoxSizer(wxHORIZONTAL);
+  options->Add(scrollback, wxSizerFlags(0).Center());
+  options->Add(captureCheck, wxSizerFlags(0).Center().Border(wxLEFT, 20));
+  options->Add(captureStatus, wxSizerFlags(1).Center().Border(wxLEFT, 10));
+  options->Add(searchButton, wxSizerFlags(0).Center().Border(wxLEFT, 10));
 
   master->Add(input, BOXITEMFLAGS);
   master->Add(output, wxSizerFlags(1).Border(wxALL, 10).Expand());
+  master->Add(options, wxSizerFlags(0).Border(wxLEFT | wxRIGHT | wxBOTTOM, 10).Expand());
 
   BindEvents();
   OpenDevice();
 
   SetSizerAndFit(master);
   Show(true);
+  syncTimer->Start(500);
 }
 
 
 SerialMonitor::~SerialMonitor() {
-#if defined(__WXOSX__) || defined(__WXGTK__)
-  close(fd);
-#elif defined(__WXMSW__)
-  CloseHandle(serHandle);
-#endif
-  if (listenerRunning) listenerThread->GetThread()->Delete();
-  if (writerRunning) writerThread->GetThread()->Delete();
+  stopNotifier.notify();
   while(listenerRunning || writerRunning) {}
+  // Only once nothing's using it
+  close(fd);
+  frameTimer->Stop();
+  delete frameTimer;
+  syncTimer->Stop();
+  delete syncTimer;
 
   instance = nullptr;
 }
@@ -69,20 +89,65 @@ wxEventTypeTag<wxCommandEvent> SerialMonitor::EVT_DISCON(wxNewEventType());
 void SerialMonitor::BindEvents()
 {
   Bind(wxEVT_TEXT_ENTER, [&](wxCommandEvent&) {
-        sendOut = SerialMonitor::instance->input->entry()->GetValue();
+        send(SerialMonitor::instance->input->entry()->GetValue().ToStdString());
         SerialMonitor::instance->input->entry()->Clear();
       }, ID_SerialCommand);
-  Bind(EVT_INPUT, [&](wxCommandEvent& evt) { output->entry()->AppendText(((SerialDataEvent*)&evt)->value); }, wxID_ANY);
+  Bind(EVT_INPUT, [&](wxCommandEvent&) {
+        // No more EVT_INPUTs come until this is drained, so whatever arrives meanwhile is shown with it
+        auto sinceFrame = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - lastFrame).count();
+        if (sinceFrame >= SERIALMONITOR_FRAME) DrainInput();
+        else if (!frameTimer->IsRunning()) frameTimer->StartOnce(SERIALMONITOR_FRAME - sinceFrame);
+      }, wxID_ANY);
+  Bind(wxEVT_TIMER, [&](wxTimerEvent&) { DrainInput(); }, ID_FrameTimer);
+  Bind(wxEVT_TIMER, [&](wxTimerEvent&) { presetSync.checkTimeout(); }, ID_SyncTimer);
+  Bind(wxEVT_SPINCTRL, [&](wxCommandEvent&) {
+        AppState::instance->serialScrollback = scrollback->entry()->GetValue();
+        AppState::instance->saveState();
+        output->setMaxLines(AppState::instance->serialScrollback);
+      }, ID_Scrollback);
+  Bind(wxEVT_CHECKBOX, [&](wxCommandEvent& event) {
+        captureWanted = event.IsChecked();
+        captureNotifier.notify();
+      }, ID_Capture);
+  Bind(wxEVT_BUTTON, [&](wxCommandEvent&) { CaptureSearch::show(static_cast<MainMenu*>(GetParent())); }, ID_SearchCaptures);
   Bind(EVT_DISCON, [&](wxCommandEvent&) {
         SerialMonitor::instance->Close(true);
       }, wxID_ANY);
 }
 
+void SerialMonitor::DrainInput()
+{
+  lastFrame = std::chrono::steady_clock::now();
+  // Cleared before reading, so anything the listener adds after this gets another event
+  inputQueued = false;
+  auto start = partialInput.size();
+  partialInput.resize(start + received.size());
+  partialInput.resize(start + received.read(partialInput.data() + start, partialInput.size() - start));
+  if (waitingForSpace.exchange(false)) spaceNotifier.notify();
+
+  // Holds back a UTF-8 character that's been split between reads
+  auto end = partialInput.size();
+  for (size_t back = 1; back <= 3 && back <= end; back++) {
+    auto byte = static_cast<uint8_t>(partialInput[end - back]);
+    if ((byte & 0xC0) == 0x80) continue;
+    size_t length = byte >= 0xF0 ? 4 : byte >= 0xE0 ? 3 : byte >= 0xC0 ? 2 : 1;
+    if (length > back) end -= back;
+    break;
+  }
+  presetSync.receive(partialInput.substr(0, end));
+  auto text = wxString::FromUTF8(partialInput.data(), end);
+  if (text.empty() && end != 0) text = wxString::From8BitData(partialInput.data(), end);
+  partialInput.erase(0, end);
+
+  text.Replace("\r", wxEmptyString);
+  if (!text.empty()) output->append(text);
+}
+
 void SerialMonitor::OpenDevice()
 {
   struct termios newtio;
 
-  fd = open(static_cast<MainMenu*>(GetParent())->boardSelect->entry()->GetValue().data(), O_RDWR | O_NOCTTY);
+  fd = open(static_cast<MainMenu*>(GetParent())->boardSelect->entry()->GetValue().data(), O_RDWR | O_NOCTTY | O_NONBLOCK);
   if (fd < 0) {
     wxMessageDialog(GetParent(), "Could not connect to proffieboard.", "Serial Error", wxICON_ERROR | wxOK).ShowModal();
     SerialMonitor::instance->Close(true);
@@ -95,71 +160,123 @@ void SerialMonitor::OpenDevice()
   newtio.c_iflag = IGNPAR;
   newtio.c_oflag = (tcflag_t) NULL;
   newtio.c_lflag &= ~ICANON; /* unset canonical */
-  newtio.c_cc[VTIME] = 1; /* 100 millis */
+  // Reads and writes return whatever they could do without waiting, poll() does the waiting
+  newtio.c_cc[VMIN] = 0;
+  newtio.c_cc[VTIME] = 0;
 
   tcflush(fd, TCIFLUSH);
   tcsetattr(fd, TCSANOW, &newtio);
 
   CreateListener();
   CreateWriter();
-
-  deviceThread = new ThreadRunner([&]() {
-    struct stat info;
-    while (SerialMonitor::instance != nullptr) {
-      if (stat(static_cast<MainMenu*>(GetParent())->boardSelect->entry()->GetValue().data(), &info)
-          != 0) { // Check if device is still present
-        SerialDataEvent* event = new SerialDataEvent(EVT_DISCON, wxID_ANY, "");
-        wxQueueEvent(SerialMonitor::instance->GetEventHandler(), event);
-        break;
-      }
-      deviceThread->GetThread()->Sleep(50);
-    }
-  });
 }
 
 void SerialMonitor::CreateListener()
 {
+  // Set here rather than in the thread, so closing right away still waits for it
+  listenerRunning = true;
   listenerThread = new ThreadRunner([&]() {
-    listenerRunning = true;
-    int32_t res;
-    char buf[255];
+    char buffer[64 * 1024];
+    bool disconnected{false};
+    std::unique_ptr<SerialCapture> capture;
+
+    while (true) {
+      auto full = received.space() == 0;
+      if (full) {
+        waitingForSpace = true;
+        // The UI may have made room before it could know to say so
+        if (received.space() != 0) {
+          waitingForSpace = false;
+          continue;
+        }
+      }
 
-    while (!listenerThread->GetThread()->TestDestroy()) {
-      res = read(fd, buf, 255);
+      // While full, nothing more is read and the board is held off by USB flow control until there's room
+      pollfd fds[3]{ { stopNotifier.fd(), POLLIN, 0 }, { full ? spaceNotifier.fd() : fd, POLLIN, 0 }, { captureNotifier.fd(), POLLIN, 0 } };
+      if (poll(fds, 3, -1) < 0) {
+        if (errno == EINTR) continue;
+        disconnected = true;
+        break;
+      }
+      if (fds[0].revents) break;
+      if (fds[2].revents) {
+        captureNotifier.clear();
+        UpdateCapture(capture);
+        if (fds[1].revents == 0) continue;
+      }
+      if (full) {
+        spaceNotifier.clear();
+        continue;
+      }
 
-      buf[res] = '\0';
-      if (res != 0) {
-        SerialDataEvent *event = new SerialDataEvent(EVT_INPUT, wxID_ANY, buf);
-        wxQueueEvent(GetEventHandler(), event);
+      // A hangup is reported as a zero-length read once whatever's left has been read
+      if ((fds[1].revents & (POLLIN | POLLHUP)) == 0) {
+        disconnected = true;
+        break;
       }
+      auto res = read(fd, buffer, std::min(sizeof(buffer), received.space()));
+      if (res < 0 && (errno == EINTR || errno == EAGAIN)) continue;
+      if (res <= 0) {
+        disconnected = true;
+        break;
+      }
+
+      received.write(buffer, res);
+      if (!inputQueued.exchange(true)) wxQueueEvent(GetEventHandler(), new wxCommandEvent(EVT_INPUT, wxID_ANY));
 
-      listenerThread->GetThread()->Sleep(50);
+      if (capture && !capture->write(buffer, res)) {
+        capture.reset();
+        captureWanted = false;
+        CallAfter([&]() {
+          captureCheck->SetValue(false);
+          captureStatus->SetLabel("Capture stopped, could not write to disk.");
+        });
+      }
     }
+    // Finished here, it's this thread's to write
+    capture.reset();
 
+    if (disconnected) wxQueueEvent(GetEventHandler(), new wxCommandEvent(EVT_DISCON, wxID_ANY));
     listenerRunning = false;
   });
 }
 
-void SerialMonitor::CreateWriter()
+void SerialMonitor::UpdateCapture(std::unique_ptr<SerialCapture>& capture)
 {
-  writerThread = new ThreadRunner([&]() {
-    writerRunning = true;
-
-    while (!writerThread->GetThread()->TestDestroy()) {
+  if (captureWanted == static_cast<bool>(capture)) return;
+  if (!captureWanted) {
+    capture.reset();
+    CallAfter([&]() { captureStatus->SetLabel(wxEmptyString); });
+    return;
+  }
 
-      if (!sendOut.empty()) {
+  capture = std::make_unique<SerialCapture>();
+  std::string error;
+  if (!capture->open(error)) {
+    capture.reset();
+    captureWanted = false;
+    CallAfter([this, error]() {
+      captureCheck->SetValue(false);
+      captureStatus->SetLabel(error);
+    });
+    return;
+  }
 
-        sendOut.resize(255);
-        sendOut.at(253) = '\r';
-        sendOut.at(254) = '\n';
+  auto session = capture->getSession();
+  CallAfter([this, session]() { captureStatus->SetLabel("Capturing to " + session); });
+}
 
-        write(fd, "\r\n", 2);
-        write(fd, sendOut.data(), 255);
-      }
-      sendOut.clear();
-      writerThread->GetThread()->Sleep(50);
-    }
+void SerialMonitor::send(const std::string& command)
+{
+  if (!writer.send(command)) std::cerr << "Serial command queue full, dropped: " << command << std::endl;
+}
 
+void SerialMonitor::CreateWriter()
+{
+  // Set here rather than in the thread, so closing right away still waits for it
+  writerRunning = true;
+  writerThread = new ThreadRunner([&]() {
+    writer.run(fd, stopNotifier.fd());
     writerRunning = false;
   });
 }
@@ -4,8 +4,24 @@
 #pragma once
 
 #if defined(__WXOSX__) || defined(__WXGTK__)
+#include "core/utilities/notifier.h"
+#include "core/utilities/ringbuffer.h"
 #include "core/utilities/threadrunner.h"
+#include "tools/presetsync.h"
+#include "tools/serialcapture.h"
+#include "tools/serialwriter.h"
+#include "ui/logview.h"
+#include "ui/pcspinctrl.h"
 #include "ui/pctextctrl.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <wx/button.h>
+#include <wx/checkbox.h>
+#include <wx/stattext.h>
+#include <wx/timer.h>
 #endif
 
 #include "mainmenu/mainmenu.h"
@@ -18,45 +34,69 @@ public:
 #if defined(__WXOSX__) || defined(__WXGTK__)
   ~SerialMonitor();
 
+  // Sent as a line of its own, after anything already waiting to go. UI thread only.
+  void send(const std::string& command);
+  // Talks to ProffieOS over this connection, fed everything the board sends
+  PresetSync& getPresetSync() { return presetSync; }
+
 private:
-  class SerialDataEvent;
   static wxEventTypeTag<wxCommandEvent> EVT_INPUT;
   static wxEventTypeTag<wxCommandEvent> EVT_DISCON;
 
   enum {
-      ID_SerialCommand
+      ID_SerialCommand,
+      ID_Scrollback,
+      ID_FrameTimer,
+      ID_Capture,
+      ID_SearchCaptures,
+      ID_SyncTimer,
   };
 
-  ThreadRunner* deviceThread{nullptr};
   ThreadRunner* listenerThread{nullptr};
   ThreadRunner* writerThread{nullptr};
 
-  bool listenerRunning{false};
-  bool writerRunning{false};
+  std::atomic<bool> listenerRunning{false};
+  std::atomic<bool> writerRunning{false};
+
+  // Filled by the listener as fast as the board sends, emptied by the UI
+  RingBuffer<char> received;
+  // Set while an EVT_INPUT is on its way, so there's only ever one
+  std::atomic<bool> inputQueued{false};
+  // Set while the listener waits for the UI to make room in `received`
+  std::atomic<bool> waitingForSpace{false};
+  Notifier spaceNotifier{};
+  Notifier stopNotifier{};
+  // Commands from the UI, written on writerThread
+  SerialWriter writer;
+  // Captures are opened, written and closed by the listener; this is what the UI asks for
+  std::atomic<bool> captureWanted{false};
+  Notifier captureNotifier{};
+  // The end of what's been read when it's partway through a character
+  std::string partialInput{};
+  // Input is shown at most once per frame, however often it arrives
+  wxTimer* frameTimer{nullptr};
+  std::chrono::steady_clock::time_point lastFrame{};
 
   pcTextCtrl* input;
-  pcTextCtrl* output;
+  LogView* output;
+  pcSpinCtrl* scrollback;
+  wxCheckBox* captureCheck;
+  wxStaticText* captureStatus;
+  wxButton* searchButton;
+
+  PresetSync presetSync;
+  wxTimer* syncTimer{nullptr};
 
   int32_t fd = 0;
-  wxString sendOut;
 
 
   void BindEvents();
   void OpenDevice();
   void CreateListener();
   void CreateWriter();
+  void DrainInput();
+  // Listener only, starts or stops the capture to match captureWanted
+  void UpdateCapture(std::unique_ptr<SerialCapture>&);
 #endif // OSX or GTK
 };
 
-#if defined(__WXOSX__) || defined(__WXGTK__)
-class SerialMonitor::SerialDataEvent : public wxCommandEvent {
-public:
-  SerialDataEvent(wxEventTypeTag<wxCommandEvent> tag, int32_t id, const wxString& message) {
-    this->SetEventType(tag);
-    this->SetId(id);
-    this->value = message;
-  }
-
-  wxString value;
-};
-#endif
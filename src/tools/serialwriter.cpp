@@ -0,0 +1,61 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "tools/serialwriter.h"
+
+#ifndef __WXMSW__
+
+#include <cerrno>
+#include <poll.h>
+#include <unistd.h>
+
+SerialWriter::SerialWriter(size_t capacity) : commands(capacity) {}
+
+bool SerialWriter::send(const std::string& command) {
+  std::string framed{command + '\n'};
+  if (!commands.push(std::move(framed))) return false;
+  commandNotifier.notify();
+  return true;
+}
+
+void SerialWriter::run(int32_t fd, int32_t stopFd) {
+  std::string command;
+
+  while (true) {
+    pollfd fds[2]{ { stopFd, POLLIN, 0 }, { commandNotifier.fd(), POLLIN, 0 } };
+    if (poll(fds, 2, -1) < 0) {
+      if (errno == EINTR) continue;
+      return;
+    }
+    if (fds[0].revents) return;
+
+    // Cleared before emptying the queue, so a command pushed meanwhile is either written now or wakes this again
+    commandNotifier.clear();
+    while (commands.pop(command)) {
+      if (!write(fd, stopFd, command)) return;
+    }
+  }
+}
+
+bool SerialWriter::write(int32_t fd, int32_t stopFd, const std::string& command) {
+  size_t written{0};
+  while (written < command.size()) {
+    auto res = ::write(fd, command.data() + written, command.size() - written);
+    if (res > 0) {
+      written += res;
+      continue;
+    }
+    if (res < 0 && errno == EINTR) continue;
+    // Gone, the reader's the one to notice and report it
+    if (res < 0 && errno != EAGAIN) return true;
+
+    // Held off by the board, but still stoppable
+    pollfd fds[2]{ { stopFd, POLLIN, 0 }, { fd, POLLOUT, 0 } };
+    if (poll(fds, 2, -1) < 0 && errno != EINTR) return true;
+    if (fds[0].revents) return false;
+    if (fds[1].revents & (POLLERR | POLLHUP | POLLNVAL)) return true;
+  }
+  return true;
+}
+
+#endif
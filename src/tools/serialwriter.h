@@ -0,0 +1,36 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#ifndef __WXMSW__
+
+#include "core/utilities/notifier.h"
+#include "core/utilities/ringbuffer.h"
+
+#include <cstdint>
+#include <string>
+
+// Writes commands to a serial port from a thread of its own, which sleeps in poll() until there's one to write
+// instead of checking on a timer, so each goes out the moment it's sent. Commands are written whole, in order,
+// even when the board holds off writes partway through one.
+class SerialWriter {
+public:
+  SerialWriter(size_t capacity);
+  SerialWriter(const SerialWriter&) = delete;
+
+  // From one thread only. Followed by a newline, false if too many are already waiting.
+  bool send(const std::string& command);
+  // Writes to `fd`, which must be non-blocking, until `stopFd` is readable.
+  // A port that's gone is left for whoever reads it to notice.
+  void run(int32_t fd, int32_t stopFd);
+
+private:
+  // False if it was stopped partway through
+  bool write(int32_t fd, int32_t stopFd, const std::string& command);
+
+  RingBuffer<std::string> commands;
+  Notifier commandNotifier{};
+};
+
+#endif
@@ -0,0 +1,138 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "tools/sizedashboard.h"
+
+#include "core/defines.h"
+#include "core/appstate.h"
+#include "core/config/buildsizes.h"
+
+#include <algorithm>
+#include <wx/datetime.h>
+#include <wx/sizer.h>
+#include <wx/statbox.h>
+
+// Past this much of flash or RAM a build is highlighted
+#define WARN_PERCENT 95
+
+SizeDashboard* SizeDashboard::instance{nullptr};
+
+void SizeDashboard::show(MainMenu* parent, const std::string& config, const std::string& board) {
+  if (instance == nullptr) instance = new SizeDashboard(parent);
+  instance->select(config, board);
+  instance->Show(true);
+  instance->Raise();
+}
+
+SizeDashboard::SizeDashboard(MainMenu* parent) : wxFrame(parent, wxID_ANY, "Size History") {
+  createUI();
+  bindEvents();
+
+# ifdef __WXMSW__
+  SetIcon( wxICON(IDI_ICON1) );
+  SetBackgroundColour(wxSystemSettings::GetColour(wxSYS_COLOUR_FRAMEBK));
+# endif
+}
+SizeDashboard::~SizeDashboard() {
+  instance = nullptr;
+}
+
+void SizeDashboard::createUI() {
+  auto sizer = new wxBoxSizer(wxVERTICAL);
+
+  auto selection = new wxBoxSizer(wxHORIZONTAL);
+  configSelect = new wxChoice(this, ID_Config);
+  boardSelect = new wxChoice(this, ID_Board);
+  selection->Add(configSelect, wxSizerFlags(1).Border(wxALL, 5));
+  selection->Add(boardSelect, wxSizerFlags(1).Border(wxALL, 5));
+
+  auto latest = new wxStaticBoxSizer(wxVERTICAL, this, "Latest Build");
+  flashLabel = new wxStaticText(latest->GetStaticBox(), wxID_ANY, "");
+  flashGauge = new wxGauge(latest->GetStaticBox(), wxID_ANY, 100, wxDefaultPosition, wxSize(-1, 15));
+  ramLabel = new wxStaticText(latest->GetStaticBox(), wxID_ANY, "");
+  ramGauge = new wxGauge(latest->GetStaticBox(), wxID_ANY, 100, wxDefaultPosition, wxSize(-1, 15));
+  latest->Add(flashLabel, FIRSTITEMFLAGS);
+  latest->Add(flashGauge, wxSizerFlags(0).Border(wxLEFT | wxRIGHT | wxBOTTOM, 5).Expand());
+  latest->Add(ramLabel, MENUITEMFLAGS);
+  latest->Add(ramGauge, wxSizerFlags(0).Border(wxLEFT | wxRIGHT | wxBOTTOM, 5).Expand());
+
+  builds = new wxListCtrl(this, wxID_ANY, wxDefaultPosition, wxSize(560, 250), wxLC_REPORT | wxLC_SINGLE_SEL);
+  builds->AppendColumn("Built", wxLIST_FORMAT_LEFT, 140);
+  builds->AppendColumn("Flash", wxLIST_FORMAT_RIGHT, 110);
+  builds->AppendColumn("Change", wxLIST_FORMAT_RIGHT, 80);
+  builds->AppendColumn("RAM", wxLIST_FORMAT_RIGHT, 110);
+  builds->AppendColumn("Change", wxLIST_FORMAT_RIGHT, 80);
+
+  sizer->Add(selection, wxSizerFlags(0).Border(wxLEFT | wxRIGHT | wxTOP, 5).Expand());
+  sizer->Add(latest, wxSizerFlags(0).Border(wxALL, 10).Expand());
+  sizer->Add(builds, wxSizerFlags(1).Border(wxLEFT | wxRIGHT | wxBOTTOM, 10).Expand());
+
+  SetSizerAndFit(sizer);
+}
+
+void SizeDashboard::bindEvents() {
+  Bind(wxEVT_CHOICE, [&](wxCommandEvent&) { updateBoards(); updateBuilds(); }, ID_Config);
+  Bind(wxEVT_CHOICE, [&](wxCommandEvent&) { updateBuilds(); }, ID_Board);
+  // Builds finish while this is open, so pick them up whenever it comes back into view
+  Bind(wxEVT_ACTIVATE, [&](wxActivateEvent& event) {
+    if (event.GetActive()) select(configSelect->GetStringSelection().ToStdString(), boardSelect->GetStringSelection().ToStdString());
+    event.Skip();
+  });
+}
+
+void SizeDashboard::select(const std::string& config, const std::string& board) {
+  configSelect->Clear();
+  for (const auto& name : AppState::instance->getConfigFileNames()) configSelect->Append(name);
+  if (!configSelect->SetStringSelection(config) && configSelect->GetCount()) configSelect->SetSelection(0);
+
+  updateBoards();
+  if (!board.empty()) boardSelect->SetStringSelection(board);
+  updateBuilds();
+}
+
+void SizeDashboard::updateBoards() {
+  auto lastBoard = boardSelect->GetStringSelection();
+  boardSelect->Clear();
+  for (const auto& board : BuildSizes::instance->getBoards(configSelect->GetStringSelection().ToStdString())) boardSelect->Append(board);
+  if (!boardSelect->SetStringSelection(lastBoard) && boardSelect->GetCount()) boardSelect->SetSelection(0);
+}
+
+void SizeDashboard::updateBuilds() {
+  builds->DeleteAllItems();
+  auto entries = BuildSizes::instance->getHistory(configSelect->GetStringSelection().ToStdString(), boardSelect->GetStringSelection().ToStdString());
+
+  auto percent = [](const CostModel::Usage& usage) { return usage.max ? static_cast<int32_t>(usage.used * 100ULL / usage.max) : 0; };
+  auto describe = [&](const CostModel::Usage& usage) { return wxString::Format("%u (%d%%)", usage.used, percent(usage)); };
+  auto change = [](uint32_t current, uint32_t previous) {
+    auto delta = static_cast<int64_t>(current) - static_cast<int64_t>(previous);
+    return delta ? wxString::Format("%+lld", static_cast<long long>(delta)) : wxString("-");
+  };
+
+  if (entries.empty()) {
+    flashLabel->SetLabel("Flash: no builds yet, verify or apply the config to record one.");
+    ramLabel->SetLabel("RAM:");
+    flashGauge->SetValue(0);
+    ramGauge->SetValue(0);
+  } else {
+    const auto& latest = entries.back();
+    flashLabel->SetLabel(wxString::Format("Flash: %u of %u bytes", latest.flash.used, latest.flash.max));
+    ramLabel->SetLabel(wxString::Format("RAM: %u of %u bytes", latest.ram.used, latest.ram.max));
+    flashGauge->SetValue(std::min(percent(latest.flash), 100));
+    ramGauge->SetValue(std::min(percent(latest.ram), 100));
+  }
+
+  // Newest first
+  for (size_t idx = entries.size(); idx-- > 0;) {
+    const auto& entry = entries[idx];
+    auto row = builds->InsertItem(builds->GetItemCount(), wxDateTime(static_cast<time_t>(entry.time)).Format("%Y-%m-%d %H:%M"));
+    builds->SetItem(row, 1, describe(entry.flash));
+    builds->SetItem(row, 3, describe(entry.ram));
+    if (idx > 0) {
+      builds->SetItem(row, 2, change(entry.flash.used, entries[idx - 1].flash.used));
+      builds->SetItem(row, 4, change(entry.ram.used, entries[idx - 1].ram.used));
+    }
+    if (percent(entry.flash) >= WARN_PERCENT || percent(entry.ram) >= WARN_PERCENT) builds->SetItemTextColour(row, *wxRED);
+  }
+
+  Layout();
+}
@@ -0,0 +1,49 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include "mainmenu/mainmenu.h"
+
+#include <string>
+
+#include <wx/choice.h>
+#include <wx/frame.h>
+#include <wx/gauge.h>
+#include <wx/listctrl.h>
+#include <wx/stattext.h>
+
+// Flash and RAM usage of each build of a config for a board over time (from BuildSizes),
+// so it's clear which change took a config close to the limit.
+class SizeDashboard : public wxFrame {
+public:
+  // Brings up the dashboard (opening it if needed), on config and board if given
+  static void show(MainMenu*, const std::string& config = {}, const std::string& board = {});
+  static SizeDashboard* instance;
+
+  SizeDashboard(MainMenu*);
+  ~SizeDashboard();
+
+private:
+
+  enum {
+    ID_Config,
+    ID_Board,
+  };
+
+  wxChoice* configSelect{nullptr};
+  wxChoice* boardSelect{nullptr};
+  wxStaticText* flashLabel{nullptr};
+  wxGauge* flashGauge{nullptr};
+  wxStaticText* ramLabel{nullptr};
+  wxGauge* ramGauge{nullptr};
+  wxListCtrl* builds{nullptr};
+
+  void createUI();
+  void bindEvents();
+
+  void select(const std::string& config, const std::string& board);
+  // Refills the board list for the selected config, keeping the selected board if it's still there
+  void updateBoards();
+  void updateBuilds();
+};
@@ -0,0 +1,176 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "tools/sketchoverlay.h"
+
+#include "core/defines.h"
+
+#include <fstream>
+#include <sstream>
+#include <string_view>
+#include <vector>
+#include <wx/dir.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+#ifdef __WXMSW__
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+bool SketchOverlay::create(const std::string& sketchPath, const std::string& configFile, ConfigSelect configSelect, std::string& error) {
+  if (!clear(sketchPath, error)) return false;
+
+  wxFileName proffieOS = wxFileName::DirName(PROFFIEOS_PATH);
+  proffieOS.MakeAbsolute();
+  if (!linkTree(proffieOS.GetPath(), sketchPath, true, error)) return false;
+
+  if (!patchIno(sketchPath, configFile, configSelect, error)) return false;
+
+  wxFileName configDir = wxFileName::DirName(sketchPath);
+  configDir.AppendDir("config");
+  if (!configDir.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL)) {
+    error = "Could not create sketch config directory";
+    return false;
+  }
+  // Copied rather than linked, the original is rewritten in place on every save
+  if (!wxCopyFile(CONFIG_DIR + configFile, wxFileName(configDir.GetPath(), configFile).GetFullPath())) {
+    error = "Could not copy " + configFile + " into sketch";
+    return false;
+  }
+
+  return true;
+}
+
+std::string SketchOverlay::getConfigProperty(const std::string& configFile, const std::string& extraFlags) {
+  // arduino-cli splits recipes on quotes, single quotes keep the doubles for the preprocessor
+  auto define = "'-DCONFIG_FILE=\"config/" + configFile + "\"'";
+  return "compiler.cpp.extra_flags=" + (extraFlags.empty() ? define : extraFlags + " " + define);
+}
+
+bool SketchOverlay::clear(const wxString& sketchPath, std::string& error) {
+  wxDir sketchDir(sketchPath);
+  if (!sketchDir.IsOpened()) return true;
+
+  wxString name;
+  std::vector<wxString> files, dirs;
+  for (bool found = sketchDir.GetFirst(&name, wxEmptyString, wxDIR_FILES | wxDIR_HIDDEN); found; found = sketchDir.GetNext(&name)) {
+    if (name != "ProffieOS.ino") files.push_back(name);
+  }
+  for (bool found = sketchDir.GetFirst(&name, wxEmptyString, wxDIR_DIRS | wxDIR_HIDDEN); found; found = sketchDir.GetNext(&name)) dirs.push_back(name);
+
+  for (const auto& file : files) {
+    if (!wxRemoveFile(wxFileName(sketchPath, file).GetFullPath())) {
+      error = "Could not clear previous sketch file " + file.ToStdString();
+      return false;
+    }
+  }
+  for (const auto& dir : dirs) {
+    if (!wxFileName::Rmdir(wxFileName(sketchPath, dir).GetFullPath(), wxPATH_RMDIR_RECURSIVE)) {
+      error = "Could not clear previous sketch directory " + dir.ToStdString();
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SketchOverlay::patchIno(const wxString& sketchPath, const std::string& configFile, ConfigSelect configSelect, std::string& error) {
+  std::ifstream input(PROFFIEOS_INO, std::ios::binary);
+  if (!input.is_open()) {
+    error = "ERROR OPENING FOR READ";
+    return false;
+  }
+  std::ostringstream original;
+  original << input.rdbuf();
+  const auto source = original.str();
+
+  const std::string configDefine = "#define CONFIG_FILE \"config/" + configFile + "\"";
+  std::string patched;
+  patched.reserve(source.size() + configDefine.size() + 1);
+  for (size_t start = 0; start < source.size();) {
+    auto end = source.find('\n', start);
+    if (end == std::string::npos) end = source.size();
+    const auto line = std::string_view(source).substr(start, end - start);
+    start = end + 1;
+
+    // Installs from before overlays had the shared ino patched in place, with a define that would override the build's
+    if (configSelect == ConfigSelect::BUILD_PROPERTY) {
+      auto indent = line.find_first_not_of(" \t");
+      if (indent != std::string_view::npos && line.substr(indent).rfind("#define CONFIG_FILE", 0) == 0) continue;
+      patched += line;
+      patched += '\n';
+      continue;
+    }
+
+    // The commented-out placeholder is kept, with the real define ahead of it
+    if (line.find(R"(// #define CONFIG_FILE "config/YOUR_CONFIG_FILE_NAME_HERE.h")") != std::string_view::npos) patched += configDefine + '\n';
+    if (line.find("#define CONFIG_FILE") == 0) patched += configDefine;
+    else if (line.find(R"(const char version[] = ")") != std::string_view::npos) patched += R"(const char version[] = ")" PROFFIEOS_VERSION R"(";)";
+    else patched += line;
+    patched += '\n';
+  }
+
+  auto inoPath = wxFileName(sketchPath, "ProffieOS.ino").GetFullPath();
+  // Left alone if it's already right, so its mtime doesn't force the sketch to rebuild
+  std::ifstream existing(inoPath.ToStdString(), std::ios::binary);
+  if (existing.is_open()) {
+    std::ostringstream current;
+    current << existing.rdbuf();
+    if (current.str() == patched) return true;
+    existing.close();
+  }
+
+  // Written to a new file and renamed over, the old one may be a link to the shared original
+  std::ofstream output((inoPath + ".tmp").ToStdString(), std::ios::binary);
+  if (!output.is_open()) {
+    error = "ERROR OPENING FOR WRITE";
+    return false;
+  }
+  output << patched;
+  output.close();
+  if (!wxRenameFile(inoPath + ".tmp", inoPath, true)) {
+    error = "ERROR SAVING PROFFIEOS FILE";
+    return false;
+  }
+  return true;
+}
+
+bool SketchOverlay::linkTree(const wxString& source, const wxString& destination, bool isRoot, std::string& error) {
+  if (!wxFileName::Mkdir(destination, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL)) {
+    error = "Could not create sketch directory " + destination.ToStdString();
+    return false;
+  }
+
+  wxDir sourceDir(source);
+  if (!sourceDir.IsOpened()) {
+    error = "Could not open " + source.ToStdString();
+    return false;
+  }
+
+  wxString name;
+  for (bool found = sourceDir.GetFirst(&name, wxEmptyString, wxDIR_FILES | wxDIR_HIDDEN); found; found = sourceDir.GetNext(&name)) {
+    if (isRoot && name == "ProffieOS.ino") continue;
+    if (!linkFile(wxFileName(source, name).GetFullPath(), wxFileName(destination, name).GetFullPath())) {
+      error = "Could not link " + name.ToStdString() + " into sketch";
+      return false;
+    }
+  }
+  for (bool found = sourceDir.GetFirst(&name, wxEmptyString, wxDIR_DIRS | wxDIR_HIDDEN); found; found = sourceDir.GetNext(&name)) {
+    if (isRoot && name == "config") continue;
+    if (!linkTree(wxFileName(source, name).GetFullPath(), wxFileName(destination, name).GetFullPath(), false, error)) return false;
+  }
+
+  return true;
+}
+
+bool SketchOverlay::linkFile(const wxString& source, const wxString& destination) {
+# ifdef __WXMSW__
+  if (CreateHardLinkW(destination.ToStdWstring().c_str(), source.ToStdWstring().c_str(), nullptr)) return true;
+# else
+  if (link(source.fn_str(), destination.fn_str()) == 0) return true;
+  // Different filesystem, or one that doesn't do hardlinks
+  if (symlink(source.fn_str(), destination.fn_str()) == 0) return true;
+# endif
+  return wxCopyFile(source, destination);
+}
@@ -0,0 +1,38 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include <string>
+
+#include <wx/string.h>
+
+// A private copy of the ProffieOS sketch for one build, made of links into PROFFIEOS_PATH,
+// so builds never write into the shared tree and any number of them can run at once.
+class SketchOverlay {
+public:
+  enum class ConfigSelect {
+    // ProffieOS.ino gets its own copy with CONFIG_FILE and version[] filled in
+    PATCH_INO,
+    // ProffieOS.ino gets its own copy with any CONFIG_FILE define taken out, the build passes getConfigProperty() instead
+    BUILD_PROPERTY
+  };
+
+  // (Re)creates `sketchPath` with everything from ProffieOS, except that config/ only gets
+  // a copy of `configFile` from CONFIG_DIR.
+  static bool create(const std::string& sketchPath, const std::string& configFile, ConfigSelect, std::string& error);
+  // --build-property value defining CONFIG_FILE, for ConfigSelect::BUILD_PROPERTY.
+  // The property replaces the core's, so `extraFlags` is what's there already, to be kept.
+  static std::string getConfigProperty(const std::string& configFile, const std::string& extraFlags);
+
+private:
+  SketchOverlay();
+  SketchOverlay(const SketchOverlay&) = delete;
+
+  // Removes everything in the sketch but a patched ProffieOS.ino, which patchIno() only rewrites if it's changed
+  static bool clear(const wxString& sketchPath, std::string& error);
+  static bool patchIno(const wxString& sketchPath, const std::string& configFile, ConfigSelect, std::string& error);
+  static bool linkTree(const wxString& source, const wxString& destination, bool isRoot, std::string& error);
+  // Hardlink where possible (cheap, and keeps mtimes so incremental builds still work), otherwise a copy
+  static bool linkFile(const wxString& source, const wxString& destination);
+};
@@ -0,0 +1,129 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "tools/speculativebuild.h"
+
+#include "core/defines.h"
+#include "core/appstate.h"
+#include "core/utilities/progress.h"
+#include "core/utilities/threadrunner.h"
+#include "editor/editorwindow.h"
+#include "tools/arduino.h"
+#include "tools/builddirs.h"
+#include "tools/firmwarecache.h"
+
+SpeculativeBuild::SpeculativeBuild(EditorWindow* _editor) : editor(_editor) {
+  delay.SetOwner(editor, EditorWindow::ID_SpeculativeBuildTimer);
+  editor->Bind(wxEVT_TIMER, [&](wxTimerEvent&) { start(); }, EditorWindow::ID_SpeculativeBuildTimer);
+}
+SpeculativeBuild::~SpeculativeBuild() {
+  delay.Stop();
+
+  std::unique_lock<std::mutex> guard(lock);
+  cancelCurrent();
+  idle.wait(guard, [&]() { return current == nullptr && !building; });
+}
+
+void SpeculativeBuild::schedule() {
+  if (!AppState::instance->speculativeBuild) return;
+
+  cancel();
+  delay.StartOnce(SPECULATIVEBUILD_DELAY);
+  setStatus("Background build: waiting...");
+}
+
+void SpeculativeBuild::cancel() {
+  std::lock_guard<std::mutex> guard(lock);
+  if (current == nullptr && !delay.IsRunning()) return;
+
+  delay.Stop();
+  cancelCurrent();
+  setStatus("Background build: outdated");
+}
+
+void SpeculativeBuild::cancelCurrent() {
+  if (current == nullptr) return;
+  current->cancel();
+  idle.notify_all();
+}
+
+void SpeculativeBuild::settle(const std::string& key, Progress* progDialog) {
+  std::unique_lock<std::mutex> guard(lock);
+  while (current != nullptr || building) {
+    if (current != nullptr && !currentKey.empty() && currentKey != key) cancelCurrent();
+    if (progDialog != nullptr) progDialog->emitEvent(-1, "Finishing background build...");
+    idle.wait_for(guard, std::chrono::milliseconds(100));
+  }
+}
+
+void SpeculativeBuild::start() {
+  if (!AppState::instance->speculativeBuild) return;
+
+  // On the UI thread, the build reads only this
+  auto target = Arduino::getBuildTarget(editor);
+  auto cancel = new Toolchain::Cancellation;
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    cancelCurrent();
+    current = cancel;
+    currentKey.clear();
+  }
+  new ThreadRunner([=]() { run(cancel, target); });
+}
+
+void SpeculativeBuild::run(Toolchain::Cancellation* cancel, const Arduino::BuildTarget& target) {
+  bool entered{false};
+  {
+    // A superseded build may not have noticed yet
+    std::unique_lock<std::mutex> guard(lock);
+    idle.wait(guard, [&]() { return !building || cancel->isCancelled(); });
+    if (!cancel->isCancelled()) building = entered = true;
+  }
+
+  wxString status;
+  if (entered) {
+    auto key = FirmwareCache::getKey(target.config, target.fqbn, target.boardOptions, target.configSelect);
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      if (current == cancel) currentKey = key;
+      idle.notify_all();
+    }
+
+    wxString returnVal;
+    if (key.empty()) {
+      status = "Background build: config not found";
+    } else if (!FirmwareCache::find(key).empty()) {
+      status = "Background build: up to date";
+    } else {
+      setStatus("Background build: compiling...");
+      if (!Arduino::updateIno(returnVal, target)) {
+        status = "Background build: failed";
+      } else if (!Arduino::compile(returnVal, target, cancel)) {
+        status = cancel->isCancelled() ? "Background build: outdated" : "Background build: failed, verify for details";
+      } else if (FirmwareCache::getKey(target.config, target.fqbn, target.boardOptions, target.configSelect) != key) {
+        // Rewritten while it was building, so there's no telling which version this is
+        status = "Background build: outdated";
+      } else {
+        auto buildDir = BuildDirs::acquire(target.config, target.fqbn, target.boardOptions);
+        FirmwareCache::store(key, buildDir.build);
+        status = "Background build: ready";
+      }
+    }
+  }
+
+  std::lock_guard<std::mutex> guard(lock);
+  // Superseded builds leave the status to the one that replaced them
+  if (current == cancel) {
+    if (!status.empty()) setStatus(status);
+    current = nullptr;
+    currentKey.clear();
+  }
+  if (entered) building = false;
+  delete cancel;
+  idle.notify_all();
+}
+
+void SpeculativeBuild::setStatus(const wxString& status) {
+  auto window = editor;
+  window->CallAfter([window, status]() { window->SetStatusText(status, 1); });
+}
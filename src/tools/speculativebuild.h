@@ -0,0 +1,53 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include "tools/arduino.h"
+#include "tools/toolchain.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <wx/string.h>
+#include <wx/timer.h>
+
+class EditorWindow;
+class Progress;
+
+// Compiles an editor's config in the background (at low priority) shortly after it's saved, into the
+// FirmwareCache, so by the time it's applied or verified the build is already done or underway.
+// Opt-in, see AppState::speculativeBuild. The state is shown in the editor's status bar.
+// What it builds is taken from the editor when the delay's up, so editing on meanwhile can't change a build partway.
+class SpeculativeBuild {
+public:
+  SpeculativeBuild(EditorWindow*);
+  ~SpeculativeBuild();
+
+  // After the config's been saved; the build starts once it's gone SPECULATIVEBUILD_DELAY without another save or edit.
+  void schedule();
+  // The config changed in the editor, so whatever is pending or building is outdated.
+  void cancel();
+  // Before building key in the foreground: waits for a background build of the same key to finish, so its result
+  // can be used, and cancels (and waits out) anything else, since it would be building in the same directory.
+  // Blocks, so not from the UI thread.
+  void settle(const std::string& key, Progress* = nullptr);
+
+private:
+  void start();
+  void run(Toolchain::Cancellation*, const Arduino::BuildTarget&);
+  void setStatus(const wxString&);
+  // Lock must be held
+  void cancelCurrent();
+
+  EditorWindow* editor{nullptr};
+  wxTimer delay{};
+
+  std::mutex lock{};
+  std::condition_variable idle{};
+  // The most recent build, pending or running, and its key once that's known
+  Toolchain::Cancellation* current{nullptr};
+  std::string currentKey{};
+  // Whether a build is in the build directory; a superseded one might still be finishing up
+  bool building{false};
+};
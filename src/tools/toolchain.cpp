@@ -0,0 +1,106 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "tools/toolchain.h"
+
+#include "core/defines.h"
+#include "tools/faketoolchain.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+Toolchain* Toolchain::instance{nullptr};
+void Toolchain::init() {
+  auto fakeScript = std::getenv("PROFFIECONFIG_FAKE_TOOLCHAIN");
+  auto recordPath = std::getenv("PROFFIECONFIG_TOOLCHAIN_RECORD");
+  if (fakeScript != nullptr && *fakeScript) {
+    std::cerr << "Using fake toolchain from " << fakeScript << std::endl;
+    instance = new FakeToolchain(fakeScript);
+  } else instance = new ArduinoToolchain(recordPath == nullptr ? std::string{} : recordPath);
+}
+Toolchain* Toolchain::get() { return instance; }
+
+void Toolchain::Cancellation::cancel() {
+  std::lock_guard<std::mutex> guard(lock);
+  cancelled = true;
+  if (handler) handler();
+  wake.notify_all();
+}
+bool Toolchain::Cancellation::isCancelled() {
+  std::lock_guard<std::mutex> guard(lock);
+  return cancelled;
+}
+void Toolchain::Cancellation::setHandler(std::function<void()> _handler) {
+  std::lock_guard<std::mutex> guard(lock);
+  handler = _handler;
+  if (cancelled && handler) handler();
+}
+bool Toolchain::Cancellation::sleep(std::chrono::milliseconds duration) {
+  std::unique_lock<std::mutex> guard(lock);
+  return !wake.wait_for(guard, duration, [&]() { return cancelled; });
+}
+
+std::map<std::string, std::string> Toolchain::getBuildProperties(const std::string& fqbn, const std::string& boardOptions, const std::string& sketch) {
+  std::lock_guard<std::mutex> guard(propertiesLock);
+  auto key = fqbn + '\0' + boardOptions;
+  auto found = buildProperties.find(key);
+  if (found != buildProperties.end()) return found->second;
+
+  std::map<std::string, std::string> properties;
+  auto exitCode = run({ "compile", "--show-properties", "-b", fqbn, "--board-options", boardOptions, sketch }, [&](const Process::Line& line) {
+    if (line.stream != Process::Stream::STDOUT) return;
+    auto split = line.text.find('=');
+    if (split != std::string::npos) properties[line.text.substr(0, split)] = line.text.substr(split + 1);
+  });
+  // Not kept, so it's tried again next time
+  if (exitCode != 0) return {};
+
+  buildProperties[key] = properties;
+  return properties;
+}
+
+ArduinoToolchain::ArduinoToolchain(const std::string& _recordPath) : recordPath(_recordPath) {}
+
+int32_t ArduinoToolchain::run(const std::vector<std::string>& args, const std::function<void(const Process::Line&)>& handler, Cancellation* cancel, bool lowPriority) {
+  std::vector<std::string> command{ ARDUINO_PATH };
+  command.insert(command.end(), args.begin(), args.end());
+
+  Process process;
+  if (!process.start(command, lowPriority)) return -1;
+  if (cancel != nullptr) cancel->setHandler([&]() { process.kill(); });
+
+  std::ostringstream recording;
+  auto lastLine = std::chrono::steady_clock::now();
+  Process::Line line;
+  while (process.readLine(line)) {
+    if (!recordPath.empty()) {
+      auto now = std::chrono::steady_clock::now();
+      auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastLine).count();
+      if (delay > 0) recording << "DELAY " << delay << '\n';
+      recording << (line.stream == Process::Stream::STDOUT ? "OUT " : "ERR ") << line.text << '\n';
+      lastLine = now;
+    }
+    handler(line);
+  }
+
+  if (cancel != nullptr) cancel->setHandler({});
+  auto exitCode = process.finish();
+  if (cancel != nullptr && cancel->isCancelled()) return -1;
+
+  if (!recordPath.empty()) {
+    // Up to the first path, which is specific to this machine
+    std::string match;
+    for (const auto& arg : args) {
+      if (arg.find_first_of("/\\") != std::string::npos) break;
+      match += (match.empty() ? "" : " ") + arg;
+    }
+
+    std::lock_guard<std::mutex> guard(recordLock);
+    std::ofstream recordFile(recordPath, std::ios::app);
+    recordFile << "MATCH " << match << '\n' << recording.str() << "EXIT " << exitCode << "\n\n";
+  }
+
+  return exitCode;
+}
@@ -0,0 +1,77 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include "tools/process.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Where arduino-cli invocations go. Normally that's the real arduino-cli, but setting
+// PROFFIECONFIG_FAKE_TOOLCHAIN to a script (see FakeToolchain) swaps in a stand-in, so the
+// Apply/Verify orchestration can be run and timed without the toolchain or a board.
+class Toolchain {
+public:
+  static void init();
+  static Toolchain* get();
+
+  // Hands a stop request from another thread to the run() it was passed to, which then returns -1.
+  class Cancellation {
+  public:
+    void cancel();
+    bool isCancelled();
+
+    // For implementations: called on cancel(), or right away if that already happened. Cleared with {}.
+    void setHandler(std::function<void()>);
+    // Sleeps for up to duration, false if cancelled first
+    bool sleep(std::chrono::milliseconds);
+
+  private:
+    std::mutex lock{};
+    std::condition_variable wake{};
+    bool cancelled{false};
+    std::function<void()> handler{};
+  };
+
+  virtual ~Toolchain() = default;
+
+  // Runs arduino-cli with args (not including the program), handing each line of output to handler as it arrives.
+  // Returns the exit code, -1 if it couldn't run or was cancelled. lowPriority is for work nobody is waiting on yet.
+  virtual int32_t run(const std::vector<std::string>& args, const std::function<void(const Process::Line&)>& handler, Cancellation* = nullptr, bool lowPriority = false) = 0;
+  // True for stand-ins, which device watching defers to instead of looking for real boards
+  virtual bool isSimulated() const { return false; }
+
+  // What arduino-cli resolves the core's build properties to for a board (`compile --show-properties`),
+  // looked up once per board and options. Empty if they couldn't be.
+  std::map<std::string, std::string> getBuildProperties(const std::string& fqbn, const std::string& boardOptions, const std::string& sketch);
+
+protected:
+  Toolchain() = default;
+  Toolchain(const Toolchain&) = delete;
+
+private:
+  static Toolchain* instance;
+
+  std::mutex propertiesLock{};
+  std::map<std::string, std::map<std::string, std::string>> buildProperties{};
+};
+
+// The real thing, at ARDUINO_PATH. Setting PROFFIECONFIG_TOOLCHAIN_RECORD to a file appends every
+// run to it as a FakeToolchain script, timing included, to be replayed later.
+class ArduinoToolchain : public Toolchain {
+public:
+  ArduinoToolchain(const std::string& recordPath = {});
+
+  int32_t run(const std::vector<std::string>&, const std::function<void(const Process::Line&)>&, Cancellation* = nullptr, bool lowPriority = false) override;
+
+private:
+  std::string recordPath{};
+  std::mutex recordLock{};
+};
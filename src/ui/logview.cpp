@@ -0,0 +1,77 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#include "ui/logview.h"
+
+#include <algorithm>
+#include <wx/clipboard.h>
+#include <wx/utils.h>
+
+LogView::LogView(wxWindow* parent, size_t _maxLines) :
+  wxListCtrl(parent, wxID_ANY, wxDefaultPosition, wxSize(500, 200), wxLC_REPORT | wxLC_VIRTUAL | wxLC_NO_HEADER),
+  maxLines(_maxLines) {
+  AppendColumn(wxEmptyString);
+
+  Bind(wxEVT_SIZE, [&](wxSizeEvent& event) {
+        SetColumnWidth(0, GetClientSize().x);
+        event.Skip();
+      });
+  Bind(wxEVT_LIST_KEY_DOWN, [&](wxListEvent& event) {
+        if (event.GetKeyCode() == 'C' && wxGetKeyState(WXK_CONTROL)) copySelection();
+      });
+}
+
+void LogView::append(const wxString& text) {
+  // Only keeps up with new output if it was already showing the end of it
+  auto following = GetTopItem() + GetCountPerPage() >= static_cast<long>(lines.size()) - 1;
+
+  for (wxString::size_type start = 0; start < text.size();) {
+    auto end = text.find('\n', start);
+    auto line = text.substr(start, end == wxString::npos ? wxString::npos : end - start);
+    if (lineOpen) lines.back() += line;
+    else lines.push_back(line);
+
+    lineOpen = end == wxString::npos;
+    if (lineOpen) break;
+    start = end + 1;
+  }
+  trim();
+
+  SetItemCount(lines.size());
+  if (following && !lines.empty()) EnsureVisible(lines.size() - 1);
+  // What's on screen may have moved up or been added to
+  if (!lines.empty()) RefreshItems(GetTopItem(), std::min<long>(GetTopItem() + GetCountPerPage(), lines.size() - 1));
+}
+
+void LogView::setMaxLines(size_t _maxLines) {
+  maxLines = _maxLines;
+  trim();
+  SetItemCount(lines.size());
+  Refresh();
+}
+
+void LogView::clear() {
+  lines.clear();
+  lineOpen = false;
+  SetItemCount(0);
+  Refresh();
+}
+
+void LogView::copySelection() {
+  wxString text;
+  for (auto item = GetNextItem(-1, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED); item != -1; item = GetNextItem(item, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED)) {
+    text += lines[item] + "\n";
+  }
+  if (text.empty() || !wxTheClipboard->Open()) return;
+
+  wxTheClipboard->SetData(new wxTextDataObject(text));
+  wxTheClipboard->Close();
+}
+
+wxString LogView::OnGetItemText(long item, long) const {
+  return item < static_cast<long>(lines.size()) ? lines[item] : wxString{};
+}
+
+void LogView::trim() {
+  while (lines.size() > maxLines) lines.pop_front();
+}
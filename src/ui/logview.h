@@ -0,0 +1,25 @@
+// ProffieConfig, All-In-One GUI Proffieboard Configuration Utility
+// Copyright (C) 2024 Ryan Ogurek
+
+#pragma once
+
+#include <deque>
+#include <wx/listctrl.h>
+
+// Only the lines on screen are ever drawn, so adding to it costs the same however long the log gets.
+// Holds up to a set number of lines, dropping the oldest.
+class LogView : public wxListCtrl {
+public:
+  LogView(wxWindow* parent, size_t maxLines);
+
+  // A line without its newline yet is continued by the next append
+  void append(const wxString&);
+  void setMaxLines(size_t);
+  void clear();
+  void copySelection();
+
+private:
+  wxString OnGetItemText(long item, long column) const override;
+  void trim();
+
+  std::deque<wxString> lines{};